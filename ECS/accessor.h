@@ -1,23 +1,157 @@
 #pragma once
 
 #include <memory>
+#include <memory_resource>
 #include <utility>
 #include <type_traits>
 #include <algorithm>
+#include <vector>
+#include <limits>
+#include <atomic>
+#include <stdexcept>
+#include <cstring>
+
+#include "component.h"
+#include "snapshot.h"
+#include "delta.h"
 
 namespace Byte {
 
 	template<template<typename> class Container>
 	class IAccessor;
 
+	template<typename ComponentContainer>
+	inline constexpr size_t CONTAINER_BLOCK_SIZE{ std::numeric_limits<size_t>::max() };
+
+	template<typename ComponentContainer>
+		requires requires { ComponentContainer::chunk_size; }
+	inline constexpr size_t CONTAINER_BLOCK_SIZE<ComponentContainer>{ ComponentContainer::chunk_size };
+
 	template<template<typename> class Container>
 	using UAccessor = std::unique_ptr<IAccessor<Container>>;
 
+	template<template<typename> class Container>
+	using SAccessor = std::shared_ptr<IAccessor<Container>>;
+
+	class TickColumn {
+	public:
+		inline static constexpr size_t BLOCK_SHIFT{ 8 };
+		inline static constexpr size_t BLOCK_SIZE{ size_t{ 1 } << BLOCK_SHIFT };
+
+	private:
+		std::vector<Tick> _added;
+		std::vector<Tick> _changed;
+		std::vector<Tick> _addedBlocks;
+		std::vector<Tick> _changedBlocks;
+		Tick _maxAdded{};
+		Tick _maxChanged{};
+
+	public:
+		const Tick* added() const {
+			return _added.data();
+		}
+
+		const Tick* changed() const {
+			return _changed.data();
+		}
+
+		const Tick* rows(bool added) const {
+			return added ? _added.data() : _changed.data();
+		}
+
+		Tick block(size_t _index, bool added) const {
+			return added ? _addedBlocks[_index >> BLOCK_SHIFT] : _changedBlocks[_index >> BLOCK_SHIFT];
+		}
+
+		Tick max(bool added) const {
+			return added ? _maxAdded : _maxChanged;
+		}
+
+		void push(Tick added, Tick changed) {
+			_added.push_back(added);
+			_changed.push_back(changed);
+			raise(_added.size() - 1, added, changed);
+		}
+
+		void move(size_t to, size_t from) {
+			_added[to] = _added[from];
+			_changed[to] = _changed[from];
+			raise(to, _added[to], _changed[to]);
+		}
+
+		void touch(size_t first, size_t count, Tick tick) {
+			std::fill_n(_changed.begin() + first, count, tick);
+
+			for (size_t block{ first >> BLOCK_SHIFT }; block <= (first + count - 1) >> BLOCK_SHIFT; ++block) {
+				store(_changedBlocks[block], tick);
+			}
+			store(_maxChanged, tick);
+		}
+
+		void resize(size_t newSize) {
+			_added.resize(newSize);
+			_changed.resize(newSize);
+		}
+
+		void append(size_t count, Tick tick) {
+			if (!count) {
+				return;
+			}
+
+			size_t first{ _added.size() };
+			_added.resize(first + count, tick);
+			_changed.resize(first + count, tick);
+
+			for (size_t block{ first >> BLOCK_SHIFT }; block <= (first + count - 1) >> BLOCK_SHIFT; ++block) {
+				raise(block << BLOCK_SHIFT, tick, tick);
+			}
+		}
+
+		void reserve(size_t newCapacity) {
+			_added.reserve(newCapacity);
+			_changed.reserve(newCapacity);
+		}
+
+		void clear() {
+			_added.clear();
+			_changed.clear();
+			_addedBlocks.clear();
+			_changedBlocks.clear();
+			_maxAdded = 0;
+			_maxChanged = 0;
+		}
+
+	private:
+		void raise(size_t _index, Tick added, Tick changed) {
+			size_t block{ _index >> BLOCK_SHIFT };
+			if (block >= _changedBlocks.size()) {
+				_addedBlocks.resize(block + 1);
+				_changedBlocks.resize(block + 1);
+			}
+
+			_addedBlocks[block] = std::max(_addedBlocks[block], added);
+			_changedBlocks[block] = std::max(_changedBlocks[block], changed);
+			_maxAdded = std::max(_maxAdded, added);
+			_maxChanged = std::max(_maxChanged, changed);
+		}
+
+		static void store(Tick& target, Tick tick) {
+			std::atomic_ref<Tick> ref{ target };
+			if (ref.load(std::memory_order_relaxed) < tick) {
+				ref.store(tick, std::memory_order_relaxed);
+			}
+		}
+	};
+
 	template<typename Component, template<typename> class Container>
 	class Accessor;
 
 	template<template<typename> class Container>
 	class IAccessor {
+	protected:
+		const Tick* _clock{ nullptr };
+		std::pmr::memory_resource* _resource{ std::pmr::get_default_resource() };
+
 	public:
 		virtual ~IAccessor() = default;
 
@@ -25,13 +159,19 @@ namespace Byte {
 
 		virtual UAccessor<Container> carry() = 0;
 
-		virtual void copyComponent(size_t _index, const UAccessor<Container>& from) = 0;
+		virtual void copyComponent(size_t _index, const SAccessor<Container>& from) = 0;
+
+		virtual void carryComponent(size_t _index, SAccessor<Container>& from) = 0;
+
+		virtual void carryComponents(const std::vector<size_t>& indices, SAccessor<Container>& from) = 0;
+
+		virtual void carryAll(SAccessor<Container>& from) = 0;
 
-		virtual void carryComponent(size_t _index, UAccessor<Container>& from) = 0;
+		virtual void moveComponent(size_t _index, SAccessor<Container>& from) = 0;
 
-		virtual void swapComponents(size_t first, size_t second) = 0;
+		virtual void eraseComponent(size_t _index) = 0;
 
-		virtual void popBack() = 0;
+		virtual void eraseComponents(const std::vector<size_t>& indices) = 0;
 
 		virtual size_t size() const = 0;
 
@@ -43,6 +183,34 @@ namespace Byte {
 
 		virtual UAccessor<Container> clone() const = 0;
 
+		virtual void save(SnapshotWriter& writer) const = 0;
+
+		virtual void load(const SnapshotBlock& block) = 0;
+
+		virtual void pushDefault() = 0;
+
+		virtual bool diff(size_t _index, const IAccessor* base, size_t baseIndex, std::vector<std::byte>& out) const = 0;
+
+		virtual void compare(const IAccessor* base, size_t count, std::vector<uint8_t>& changed) const = 0;
+
+		virtual void patch(size_t _index, SnapshotReader& reader) = 0;
+
+		virtual const TickColumn* ticks() const {
+			return nullptr;
+		}
+
+		void clock(const Tick* clock) {
+			_clock = clock;
+		}
+
+		Tick now() const {
+			return _clock ? *_clock : 0;
+		}
+
+		std::pmr::memory_resource* resource() const {
+			return _resource;
+		}
+
 		template<typename Component>
 		Accessor<Component, Container>& receive() {
 			return *static_cast<Accessor<Component, Container>*>(this);
@@ -55,10 +223,32 @@ namespace Byte {
 	public:
 		using ComponentContainer = Container<Component>;
 
+		inline static constexpr size_t BLOCK_SIZE{ CONTAINER_BLOCK_SIZE<ComponentContainer> };
+		inline static constexpr bool TRACKED{ TRACK_CHANGES<Component> };
+		inline static constexpr bool TRIVIAL{ std::is_trivially_copyable_v<Component> };
+
 	private:
+		struct NoTickColumn {};
+
 		ComponentContainer container;
+		std::conditional_t<TRACKED, TickColumn, NoTickColumn> tickColumn;
 
 	public:
+		Accessor() = default;
+
+		// Containers built on std::pmr::polymorphic_allocator draw from resource; others keep their own allocator.
+		explicit Accessor(std::pmr::memory_resource* resource)
+			: container{ makeContainer(resource) } {
+			this->_resource = resource;
+		}
+
+		Accessor(const Accessor& left)
+			: IAccessor<Container>{ left }, container{ makeContainer(left._resource) }, tickColumn{ left.tickColumn } {
+			container = left.container;
+		}
+
+		Accessor(Accessor&& right) noexcept = default;
+
 		UAccessor<Container> copy() const override {
 			return std::make_unique<Accessor>(*this);
 		}
@@ -67,22 +257,122 @@ namespace Byte {
 			return std::make_unique<Accessor>(std::move(*this));
 		}
 
-		void copyComponent(size_t _index, const UAccessor<Container>& from) override {
+		void copyComponent(size_t _index, const SAccessor<Container>& from) override {
 			Accessor* castedFrom{ static_cast<Accessor*>(from.get()) };
-			container.push_back(castedFrom->get(_index));
+			container.push_back(castedFrom->container[_index]);
+			if constexpr (TRACKED) {
+				tickColumn.push(this->now(), this->now());
+			}
 		}
 
-		void carryComponent(size_t _index, UAccessor<Container>& from) override {
+		void carryComponent(size_t _index, SAccessor<Container>& from) override {
 			Accessor* castedFrom{ static_cast<Accessor*>(from.get()) };
-			container.push_back(std::move(castedFrom->get(_index)));
+			container.push_back(std::move(castedFrom->container[_index]));
+			if constexpr (TRACKED) {
+				tickColumn.push(castedFrom->tickColumn.added()[_index], castedFrom->tickColumn.changed()[_index]);
+			}
 		}
 
-		void swapComponents(size_t first, size_t second) override {
-			std::swap(container.at(first), container.at(second));
+		// carryComponent followed by from->eraseComponent, in one dispatch.
+		void moveComponent(size_t _index, SAccessor<Container>& from) override {
+			carryComponent(_index, from);
+			static_cast<Accessor*>(from.get())->eraseComponent(_index);
 		}
 
-		void popBack()  override {
+		// Overwrites the row with the last one and drops the tail; unlike a swap, the erased value is never moved back.
+		void eraseComponent(size_t _index) override {
+			size_t lastIndex{ container.size() - 1 };
+
+			if (_index != lastIndex) {
+				if constexpr (TRIVIAL) {
+					std::memcpy(data(_index), data(lastIndex), sizeof(Component));
+				}
+				else {
+					container[_index] = std::move(container[lastIndex]);
+				}
+				if constexpr (TRACKED) {
+					tickColumn.move(_index, lastIndex);
+				}
+			}
+
 			container.pop_back();
+			if constexpr (TRACKED) {
+				tickColumn.resize(lastIndex);
+			}
+		}
+
+		void carryComponents(const std::vector<size_t>& indices, SAccessor<Container>& from) override {
+			Accessor* castedFrom{ static_cast<Accessor*>(from.get()) };
+			container.reserve(container.size() + indices.size());
+			if constexpr (TRIVIAL) {
+				for (size_t first{}; first < indices.size();) {
+					size_t last{ first + 1 };
+					while (last < indices.size() && indices[last] == indices[last - 1] + 1) {
+						++last;
+					}
+					appendRows(*castedFrom, indices[first], last - first);
+					first = last;
+				}
+			}
+			else {
+				for (size_t _index : indices) {
+					container.push_back(std::move(castedFrom->container[_index]));
+				}
+			}
+			if constexpr (TRACKED) {
+				for (size_t _index : indices) {
+					tickColumn.push(castedFrom->tickColumn.added()[_index], castedFrom->tickColumn.changed()[_index]);
+				}
+			}
+		}
+
+		void carryAll(SAccessor<Container>& from) override {
+			Accessor* castedFrom{ static_cast<Accessor*>(from.get()) };
+			size_t count{ castedFrom->container.size() };
+			container.reserve(container.size() + count);
+			if constexpr (TRIVIAL) {
+				appendRows(*castedFrom, 0, count);
+			}
+			else {
+				for (size_t _index{}; _index < count; ++_index) {
+					container.push_back(std::move(castedFrom->container[_index]));
+				}
+			}
+			if constexpr (TRACKED) {
+				for (size_t _index{}; _index < count; ++_index) {
+					tickColumn.push(castedFrom->tickColumn.added()[_index], castedFrom->tickColumn.changed()[_index]);
+				}
+				castedFrom->tickColumn.clear();
+			}
+			castedFrom->container.clear();
+		}
+
+		void eraseComponents(const std::vector<size_t>& indices) override {
+			size_t newSize{ container.size() - indices.size() };
+			size_t tail{ newSize };
+			size_t next{ static_cast<size_t>(
+				std::lower_bound(indices.begin(), indices.end(), newSize) - indices.begin()) };
+
+			for (size_t hole : indices) {
+				if (hole >= newSize) {
+					break;
+				}
+				while (next < indices.size() && indices[next] == tail) {
+					++next;
+					++tail;
+				}
+				if constexpr (TRACKED) {
+					tickColumn.move(hole, tail);
+				}
+				container[hole] = std::move(container[tail++]);
+			}
+
+			while (container.size() > newSize) {
+				container.pop_back();
+			}
+			if constexpr (TRACKED) {
+				tickColumn.resize(newSize);
+			}
 		}
 
 		size_t size() const override {
@@ -91,6 +381,9 @@ namespace Byte {
 
 		void reserve(size_t newCapacity) override {
 			container.reserve(newCapacity);
+			if constexpr (TRACKED) {
+				tickColumn.reserve(newCapacity);
+			}
 		}
 
 		size_t capacity() const override {
@@ -99,28 +392,140 @@ namespace Byte {
 
 		void clear() override {
 			container.clear();
+			if constexpr (TRACKED) {
+				tickColumn.clear();
+			}
 		}
 
 		UAccessor<Container> clone() const override {
-			return std::make_unique<Accessor>();
+			UAccessor<Container> out{ std::make_unique<Accessor>(this->_resource) };
+			out->clock(this->_clock);
+			return out;
+		}
+
+		void save(SnapshotWriter& writer) const override {
+			saveColumn<Component>(writer, container.size(), BLOCK_SIZE, [this](size_t first) {
+				return data(first);
+			});
+		}
+
+		void load(const SnapshotBlock& block) override {
+			loadColumn<Component>(block, container);
+			if constexpr (TRACKED) {
+				tickColumn.append(block.count, this->now());
+			}
+		}
+
+		void pushDefault() override {
+			if constexpr (std::is_default_constructible_v<Component>) {
+				emplaceBack();
+			}
+			else {
+				throw std::logic_error("Component needs a default constructor to be replicated");
+			}
+		}
+
+		bool diff(size_t _index, const IAccessor<Container>* base, size_t baseIndex, std::vector<std::byte>& out) const override {
+			const Accessor* castedBase{ static_cast<const Accessor*>(base) };
+			return diffComponent(container[_index], castedBase ? castedBase->data(baseIndex) : nullptr, out);
+		}
+
+		void compare(const IAccessor<Container>* base, size_t count, std::vector<uint8_t>& changed) const override {
+			const Accessor* castedBase{ static_cast<const Accessor*>(base) };
+
+			for (size_t _index{}; _index < count; ++_index) {
+				if constexpr (std::is_trivially_copyable_v<Component>) {
+					changed[_index] |= std::memcmp(data(_index), castedBase->data(_index), sizeof(Component)) != 0;
+				}
+				else {
+					changed[_index] = 1;
+				}
+			}
+		}
+
+		void patch(size_t _index, SnapshotReader& reader) override {
+			if (patchComponent(container[_index], reader)) {
+				touch(_index, 1);
+			}
+		}
+
+		const TickColumn* ticks() const override {
+			if constexpr (TRACKED) {
+				return &tickColumn;
+			}
+			else {
+				return nullptr;
+			}
+		}
+
+		void touch(size_t first, size_t count) {
+			if constexpr (TRACKED) {
+				if (count) {
+					tickColumn.touch(first, count, this->now());
+				}
+			}
 		}
 
 		Component& get(size_t _index) {
-			return container.at(_index);
+			Component& out{ container.at(_index) };
+			touch(_index, 1);
+			return out;
 		}
 
 		const Component& get(size_t _index) const {
 			return container.at(_index);
 		}
 
-		template<typename Component>
-		void pushBack(Component&& component) {
-			container.push_back(std::forward<Component>(component));
+		Component* data(size_t _index) {
+			return &container[_index];
+		}
+
+		const Component* data(size_t _index) const {
+			return &container[_index];
+		}
+
+		template<typename _Component>
+		void pushBack(_Component&& component) {
+			container.push_back(std::forward<_Component>(component));
+			if constexpr (TRACKED) {
+				tickColumn.push(this->now(), this->now());
+			}
 		}
 		
 		template<typename... Args>
 		void emplaceBack(Args&&... args) {
 			container.emplace_back(std::forward<Args>(args)...);
+			if constexpr (TRACKED) {
+				tickColumn.push(this->now(), this->now());
+			}
+		}
+
+	private:
+		static ComponentContainer makeContainer(std::pmr::memory_resource* resource) {
+			if constexpr (std::is_constructible_v<ComponentContainer, std::pmr::polymorphic_allocator<Component>>) {
+				return ComponentContainer(std::pmr::polymorphic_allocator<Component>{ resource });
+			}
+			else {
+				return ComponentContainer{};
+			}
+		}
+
+		// Copies a run of trivially copyable rows block by block, so contiguous containers see a single memmove.
+		void appendRows(const Accessor& from, size_t first, size_t count) {
+			while (count) {
+				size_t length{ std::min(count, BLOCK_SIZE - first % BLOCK_SIZE) };
+				const Component* values{ from.data(first) };
+
+				if constexpr (requires { container.append(values, length); }) {
+					container.append(values, length);
+				}
+				else {
+					container.insert(container.end(), values, values + length);
+				}
+
+				first += length;
+				count -= length;
+			}
 		}
  
 	};
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <algorithm>
+
+namespace Byte {
+
+	template<typename _Type, size_t _ALIGNMENT = 64>
+	struct aligned_allocator {
+		using value_type = _Type;
+
+		inline static constexpr size_t alignment{ std::max(_ALIGNMENT, alignof(value_type)) };
+
+		template<typename _Other>
+		struct rebind {
+			using other = aligned_allocator<_Other, _ALIGNMENT>;
+		};
+
+		aligned_allocator() = default;
+
+		template<typename _Other>
+		aligned_allocator(const aligned_allocator<_Other, _ALIGNMENT>&) noexcept {
+		}
+
+		value_type* allocate(size_t count) {
+			return static_cast<value_type*>(::operator new(count * sizeof(value_type), std::align_val_t{ alignment }));
+		}
+
+		void deallocate(value_type* pointer, size_t) noexcept {
+			::operator delete(pointer, std::align_val_t{ alignment });
+		}
+
+		template<typename _Other>
+		bool operator==(const aligned_allocator<_Other, _ALIGNMENT>&) const noexcept {
+			return true;
+		}
+
+		template<typename _Other>
+		bool operator!=(const aligned_allocator<_Other, _ALIGNMENT>&) const noexcept {
+			return false;
+		}
+	};
+
+}
\ No newline at end of file
@@ -5,10 +5,19 @@
 #include <type_traits>
 #include <tuple>
 #include <iostream>
+#include <limits>
+#include <algorithm>
+#include <array>
+#include <utility>
+#include <span>
+#include <optional>
+#include <stdexcept>
+#include <memory_resource>
 
 #include "accessor.h"
 #include "component.h"
 #include "signature.h"
+#include "prefetch.h"
 
 namespace Byte {
 
@@ -25,18 +34,43 @@ namespace Byte {
 		using Container = _Container<Component>;
 		template<typename Component>
 		using Accessor = Accessor<Component, Container>;
-		using UAccessor = UAccessor<Container>;
-		using AccessorMap = std::unordered_map<ComponentID, UAccessor>;
-		using Signature = Signature<MAX_COMPONENT_COUNT>;
+		using IAccessor = Byte::IAccessor<Container>;
+		using UAccessor = Byte::UAccessor<Container>;
+		using SAccessor = Byte::SAccessor<Container>;
+		using ColumnIDVector = std::vector<ComponentID>;
+		using ColumnVector = std::vector<SAccessor>;
+		using SlotVector = std::vector<uint16_t>;
+		using Signature = Byte::Signature<MAX_COMPONENT_COUNT>;
+
+		struct Edge {
+			Archetype* add{ nullptr };
+			Archetype* remove{ nullptr };
+		};
+
+		using EdgeMap = std::unordered_map<ComponentID, Edge>;
+
+		inline static constexpr uint16_t NO_COLUMN{ std::numeric_limits<uint16_t>::max() };
+
+		inline static const TickFilterVector NO_FILTERS{};
 		
 	private:
-		AccessorMap _accessors;
+		ColumnIDVector _ids;
+		ColumnVector _columns;
+		SlotVector _slots;
 		Signature _signature;
+		EdgeMap _edges;
+		const Tick* _clock{ nullptr };
+		std::pmr::memory_resource* _resource{ std::pmr::get_default_resource() };
 
 	public:
-		Archetype() {
+		Archetype()
+			: Archetype{ std::pmr::get_default_resource() } {
+		}
+
+		explicit Archetype(std::pmr::memory_resource* resource)
+			: _resource{ resource } {
 			emplaceAccessor<EntityID>();
-		};
+		}
 
 		Archetype(const Archetype& left)
 			: Archetype{ left.copy() } {
@@ -53,10 +87,23 @@ namespace Byte {
 
 		~Archetype() = default;
 
-		const Signature& signature() {
+		const Signature& signature() const {
 			return _signature;
 		}
 
+		std::pmr::memory_resource* resource() const {
+			return _resource;
+		}
+
+		void clock(const Tick* clock) {
+			_clock = clock;
+			for (SAccessor& column : _columns) {
+				if (column.use_count() == 1) {
+					column->clock(clock);
+				}
+			}
+		}
+
 		size_t pushEntity(EntityID id) {
 			pushComponent(id);
 			return size() - 1;
@@ -64,110 +111,346 @@ namespace Byte {
 
 		template<typename Component>
 		void pushComponent(Component&& component) {
-			_accessors[Registry<std::decay_t<Component>>::id()]
-				->receive<std::decay_t<Component>>().pushBack(std::forward<Component>(component));
+			if constexpr (!TAG_COMPONENT<std::decay_t<Component>>) {
+				accessor<std::decay_t<Component>>().pushBack(std::forward<Component>(component));
+			}
 		}
 
 		template<typename Component, typename... Args>
 		void emplaceComponent(Args&&... args) {
-			_accessors[Registry<std::decay_t<Component>>::id()]
-				->receive<std::decay_t<Component>>().emplaceBack(std::forward<Args>(args)...);
+			if constexpr (!TAG_COMPONENT<std::decay_t<Component>>) {
+				accessor<std::decay_t<Component>>().emplaceBack(std::forward<Args>(args)...);
+			}
 		}
 
 		template<typename Component>
 		Component& getComponent(size_t _index) {
-			return _accessors[Registry<std::decay_t<Component>>::id()]
-				->receive<std::decay_t<Component>>().get(_index);
+			static_assert(!TAG_COMPONENT<std::decay_t<Component>>, "Tag components have no storage; test for them with has()");
+			return accessor<std::decay_t<Component>>().get(_index);
 		}
 
 		template<typename Component>
 		const Component& getComponent(size_t _index) const {
-			return _accessors[Registry<std::decay_t<Component>>::id()]
-				->receive<std::decay_t<Component>>().get(_index);
+			static_assert(!TAG_COMPONENT<std::decay_t<Component>>, "Tag components have no storage; test for them with has()");
+			return accessor<std::decay_t<Component>>().get(_index);
 		}
 
 		EntityID erase(size_t _index) {
+			own();
 			size_t lastIndex{ size() - 1 };
 
 			EntityID out{ getComponent<EntityID>(lastIndex) };
 
-			for (auto& pair : _accessors) {
-				pair.second->swapComponents(_index, lastIndex);
-				pair.second->popBack();
+			for (SAccessor& column : _columns) {
+				column->eraseComponent(_index);
 			}
 
 			return out;
 		}
 
-		size_t carryEntity(size_t _index, EntityID id, Archetype& from) {
-			pushEntity(id);
-			for (auto& pair : from._accessors) {
-				auto accessor{ _accessors.find(pair.first) };
-				if (accessor != _accessors.end()) {
-					accessor->second->carryComponent(_index, pair.second);
+		// carryEntity followed by from.erase, visiting each column once; returns the new index and the entity that filled the hole.
+		std::pair<size_t, EntityID> transferEntity(size_t _index, EntityID id, Archetype& from) {
+			own();
+			from.own();
+
+			size_t out{ pushEntity(id) };
+			EntityID changed{ from.entity(from.size() - 1) };
+			ComponentID entityID{ Registry<EntityID>::id() };
+
+			size_t toSlot{};
+			for (size_t fromSlot{}; fromSlot < from._ids.size(); ++fromSlot) {
+				while (toSlot < _ids.size() && _ids[toSlot] < from._ids[fromSlot]) {
+					++toSlot;
+				}
+
+				if (toSlot < _ids.size() && _ids[toSlot] == from._ids[fromSlot] && _ids[toSlot] != entityID) {
+					_columns[toSlot]->moveComponent(_index, from._columns[fromSlot]);
+				}
+				else {
+					from._columns[fromSlot]->eraseComponent(_index);
 				}
 			}
+
+			return { out, changed };
+		}
+
+		size_t carryEntity(size_t _index, EntityID id, Archetype& from) {
+			own();
+			from.own();
+			pushEntity(id);
+			join(from, [_index](SAccessor& to, SAccessor& from) {
+				to->carryComponent(_index, from);
+			});
 			return size() - 1;
 		}
 
 		size_t copyEntity(size_t _index, EntityID id, const Archetype& from) {
+			own();
 			pushEntity(id);
-			for (auto& pair : from._accessors) {
-				auto accessor{ _accessors.find(pair.first) };
-				if (accessor != _accessors.end()) {
-					accessor->second->copyComponent(_index, pair.second);
+			join(from, [_index](SAccessor& to, const SAccessor& from) {
+				to->copyComponent(_index, from);
+			});
+			return size() - 1;
+		}
+
+		size_t carryEntities(const std::vector<size_t>& indices, Archetype& from) {
+			own();
+			from.own();
+			size_t first{ size() };
+			join<true>(from, [&indices](SAccessor& to, SAccessor& from) {
+				to->carryComponents(indices, from);
+			});
+			return first;
+		}
+
+		size_t carryAll(Archetype& from) {
+			size_t first{ size() };
+			if (first) {
+				own();
+				from.own();
+			}
+			join<true>(from, [first](SAccessor& to, SAccessor& from) {
+				if (first == 0) {
+					std::swap(to, from);
+				}
+				else {
+					to->carryAll(from);
 				}
+			});
+			from.clear();
+			return first;
+		}
+
+		void eraseEntities(const std::vector<size_t>& indices) {
+			own();
+			for (SAccessor& column : _columns) {
+				column->eraseComponents(indices);
 			}
-			return size() - 1;
+		}
+
+		template<typename Component>
+		void pushComponents(size_t count, const Component& component) {
+			if constexpr (!TAG_COMPONENT<Component>) {
+				Accessor<Component>& column{ accessor<Component>() };
+				column.reserve(column.size() + count);
+				for (size_t idx{}; idx < count; ++idx) {
+					column.pushBack(component);
+				}
+			}
+		}
+
+		EntityID entity(size_t _index) const {
+			return getComponent<EntityID>(_index);
 		}
 
 		size_t size() const {
-			return _accessors.at(Registry<EntityID>::id())->size();
+			return _columns[_slots[Registry<EntityID>::id()]]->size();
 		}
 
 		bool empty() const {
-			return _accessors.at(Registry<EntityID>::id())->size() == 0;
+			return size() == 0;
 		}
 
 		Archetype copy() const {
-			Archetype out;
+			Archetype out{ _resource };
 
 			out._signature = _signature;
-
-			for (auto& pair : _accessors) {
-				out._accessors.emplace(pair.first, pair.second->copy());
+			out._clock = _clock;
+			out._ids = _ids;
+			out._slots = _slots;
+			out._columns.clear();
+			out._columns.reserve(_columns.size());
+
+			for (const SAccessor& column : _columns) {
+				out._columns.push_back(column->copy());
 			}
 
 			return out;
 		}
+
+		// Like copy(), but the columns stay shared until either archetype mutates one of them.
+		Archetype share() const {
+			Archetype out{ _resource };
+
+			out._signature = _signature;
+			out._clock = _clock;
+			out._ids = _ids;
+			out._slots = _slots;
+			out._columns = _columns;
+
+			return out;
+		}
+
+		template<typename... Components>
+		void unshare() {
+			if constexpr (sizeof...(Components) == 0) {
+				own();
+			}
+			else {
+				(own<Components>(), ...);
+			}
+		}
 		
 		void clear() {
-			for (auto& pair : _accessors) {
-				pair.second->clear();
+			for (SAccessor& column : _columns) {
+				if (column.use_count() > 1) {
+					column = column->clone();
+					column->clock(_clock);
+				}
+				else {
+					column->clear();
+				}
 			}
 		}
 
 		template<typename Component>
 		void emplaceAccessor() {
-			_accessors.emplace(
-				Registry<std::decay_t<Component>>::id(), std::make_unique<Accessor<std::decay_t<Component>>>());
-			_signature.set(Registry<std::decay_t<Component>>::id());
+			if constexpr (TAG_COMPONENT<std::decay_t<Component>>) {
+				_signature.set(Registry<std::decay_t<Component>>::id());
+			}
+			else if (column(Registry<std::decay_t<Component>>::id()) == NO_COLUMN) {
+				setColumn(
+					Registry<std::decay_t<Component>>::id(), std::make_unique<Accessor<std::decay_t<Component>>>(_resource));
+			}
+		}
+
+		void emplaceAccessor(ComponentID id, UAccessor accessor) {
+			if (!accessor) {
+				_signature.set(id);
+			}
+			else if (column(id) == NO_COLUMN) {
+				setColumn(id, std::move(accessor));
+			}
 		}
 
 		void eraseAccessor(ComponentID id) {
-			_accessors.erase(id);
+			uint16_t slot{ column(id) };
+
+			if (slot != NO_COLUMN) {
+				_ids.erase(_ids.begin() + slot);
+				_columns.erase(_columns.begin() + slot);
+				rebuildSlots();
+			}
+
 			_signature.set(id, false);
 		}
 
 		void reserve(size_t newCapacity) {
-			for (auto& pair : _accessors) {
-				pair.second->reserve(newCapacity);
+			own();
+			for (SAccessor& column : _columns) {
+				column->reserve(newCapacity);
+			}
+		}
+
+		uint16_t column(ComponentID id) const {
+			return id < _slots.size() ? _slots[id] : NO_COLUMN;
+		}
+
+		const ColumnIDVector& columnIDs() const {
+			return _ids;
+		}
+
+		IAccessor* columnAccessor(ComponentID id) {
+			uint16_t slot{ column(id) };
+			return slot == NO_COLUMN ? nullptr : own(slot).get();
+		}
+
+		const IAccessor* columnAccessor(ComponentID id) const {
+			uint16_t slot{ column(id) };
+			return slot == NO_COLUMN ? nullptr : _columns[slot].get();
+		}
+
+		void pushDefaults(const Archetype* source) {
+			own();
+			for (size_t slot{}; slot < _ids.size(); ++slot) {
+				if (_ids[slot] != Registry<EntityID>::id() && (!source || source->column(_ids[slot]) == NO_COLUMN)) {
+					_columns[slot]->pushDefault();
+				}
 			}
 		}
 
+		Archetype* addEdge(ComponentID id) const {
+			auto result{ _edges.find(id) };
+			return result != _edges.end() ? result->second.add : nullptr;
+		}
+
+		Archetype* removeEdge(ComponentID id) const {
+			auto result{ _edges.find(id) };
+			return result != _edges.end() ? result->second.remove : nullptr;
+		}
+
+		void link(ComponentID id, Archetype& to) {
+			_edges[id].add = &to;
+			to._edges[id].remove = this;
+		}
+
+		const EdgeMap& edges() const {
+			return _edges;
+		}
+
+		template<typename Resolver>
+		void relink(const EdgeMap& source, Resolver&& resolver) {
+			_edges.clear();
+			for (auto& pair : source) {
+				Edge& edge{ _edges[pair.first] };
+				edge.add = pair.second.add ? resolver(*pair.second.add) : nullptr;
+				edge.remove = pair.second.remove ? resolver(*pair.second.remove) : nullptr;
+			}
+		}
+
+		void save(SnapshotWriter& writer) const {
+			uint64_t tags{};
+			_signature.each([this, &tags](ComponentID id) {
+				tags += column(id) == NO_COLUMN;
+			});
+
+			writer.value<uint64_t>(_columns.size());
+			writer.value<uint64_t>(tags);
+
+			_signature.each([this, &writer](ComponentID id) {
+				if (column(id) == NO_COLUMN) {
+					writer.value(ComponentIDGenerator::key(id));
+				}
+			});
+
+			for (const SAccessor& column : _columns) {
+				column->save(writer);
+			}
+		}
+
+		template<typename Factory>
+		static Archetype load(SnapshotReader& reader, Factory&& factory, std::pmr::memory_resource* resource) {
+			Archetype out{ resource };
+
+			uint64_t columns{ reader.value<uint64_t>() };
+			uint64_t tags{ reader.value<uint64_t>() };
+
+			for (uint64_t _index{}; _index < tags; ++_index) {
+				out._signature.set(ComponentIDGenerator::find(reader.value<ComponentKey>()));
+			}
+
+			std::optional<size_t> rows;
+			for (uint64_t _index{}; _index < columns; ++_index) {
+				SnapshotBlock block{ reader.block() };
+				ComponentID id{ ComponentIDGenerator::find(block.key) };
+
+				UAccessor column{ id == Registry<EntityID>::id() ? std::make_unique<Accessor<EntityID>>(resource) : factory(id) };
+				column->load(block);
+
+				if (rows && *rows != column->size()) {
+					throw std::runtime_error("Snapshot archetype columns differ in length");
+				}
+				rows = column->size();
+
+				out.setColumn(id, std::move(column));
+			}
+
+			return out;
+		}
+
 		template<typename... Components>
-		static Archetype build() {
-			Archetype out;
+		static Archetype build(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) {
+			Archetype out{ resource };
 			((out.emplaceAccessor<std::decay_t<Components>>()), ...);
 
 			return out;
@@ -175,23 +458,25 @@ namespace Byte {
 
 		template<typename... Components>
 		static Archetype build(Archetype& source) {
-			Archetype out{ build<Components...>() };
+			Archetype out{ build<Components...>(source._resource) };
+			out._signature += source._signature;
 
-			for (auto& pair : source._accessors) {
-				out._accessors[pair.first] = pair.second->clone();
-				out._signature.set(pair.first);
+			for (size_t slot{}; slot < source._ids.size(); ++slot) {
+				if (out.column(source._ids[slot]) == NO_COLUMN) {
+					out.setColumn(source._ids[slot], source._columns[slot]->clone());
+				}
 			}
 			return out;
 		}
 
 		static Archetype build(Archetype& source, ComponentID without) {
-			Archetype out;
+			Archetype out{ source._resource };
 			out._signature = source._signature;
 			out._signature.set(without, false);
 
-			for (auto& pair : source._accessors) {
-				if (pair.first != without) {
-					out._accessors[pair.first] = pair.second->clone();
+			for (size_t slot{}; slot < source._ids.size(); ++slot) {
+				if (source._ids[slot] != without && out.column(source._ids[slot]) == NO_COLUMN) {
+					out.setColumn(source._ids[slot], source._columns[slot]->clone());
 				}
 			}
 			return out;
@@ -201,43 +486,343 @@ namespace Byte {
 		class Cache {
 		public:
 			using ComponentGroup = std::tuple<Components&...>;
-			using AccessorVector = std::vector<IAccessor<Container>*>;
+			using AccessorArray = std::array<IAccessor*, sizeof...(Components)>;
 
 		private:
-			AccessorVector _accessors;
+			AccessorArray _accessors{};
+			std::tuple<TagSlot<std::decay_t<Components>>...> _tags;
 
 		public:
 			Cache() = default;
 
-			Cache(Archetype& arche) {
-				((_accessors.push_back(arche._accessors.at(Registry<Components>::id()).get())), ...);
+			Cache(Archetype& arche)
+				: _accessors{ find<Components>(arche)... } {
 			}
 
 			ComponentGroup group(size_t _index) {
-				size_t iterator{ this->_accessors.size() };
-				return ComponentGroup(this->get<Components>(_index, --iterator)...);
+				return group(_index, std::index_sequence_for<Components...>{});
+			}
+
+			void prefetch(size_t _index) const {
+				prefetch(_index, std::index_sequence_for<Components...>{});
 			}
 
 			size_t size() const {
-				if (_accessors.empty()) {
-					return 0;
+				for (IAccessor* accessor : _accessors) {
+					if (accessor) {
+						return accessor->size();
+					}
 				}
-				return _accessors[0]->size();
+				return 0;
 			}
 
 		private:
 			template<typename Component>
-			Component& get(size_t _index, size_t accessorIndex) {
-				return static_cast<Accessor<Component>*>(_accessors[accessorIndex])->get(_index);
+			static IAccessor* find(Archetype& arche) {
+				if constexpr (TAG_COMPONENT<std::decay_t<Component>>) {
+					return nullptr;
+				}
+				else if constexpr (std::is_const_v<Component>) {
+					return const_cast<IAccessor*>(std::as_const(arche).columnAccessor(Registry<std::decay_t<Component>>::id()));
+				}
+				else {
+					return arche.own(arche.column(Registry<std::decay_t<Component>>::id())).get();
+				}
+			}
+
+			template<size_t... Indices>
+			ComponentGroup group(size_t _index, std::index_sequence<Indices...>) {
+				(touch<Components>(static_cast<Accessor<std::decay_t<Components>>*>(_accessors[Indices]), _index, 1), ...);
+				return ComponentGroup(
+					*rows<Components>(static_cast<Accessor<std::decay_t<Components>>*>(_accessors[Indices]), _index, std::get<Indices>(_tags))...);
+			}
+
+			template<size_t... Indices>
+			void prefetch(size_t _index, std::index_sequence<Indices...>) const {
+				(prefetchRow<Components>(static_cast<Accessor<std::decay_t<Components>>*>(_accessors[Indices]), _index), ...);
+			}
+
+			template<typename Component>
+			static void prefetchRow(const Accessor<std::decay_t<Component>>* column, size_t _index) {
+				if constexpr (!TAG_COMPONENT<std::decay_t<Component>>) {
+					Byte::prefetch(column->data(_index));
+				}
 			}
 
 		};
 
+		template<typename... Components, typename Function>
+		void each(Function&& function) {
+			each<Components...>(0, size(), function);
+		}
+
+		template<typename... Components, typename Function>
+		void each(size_t first, size_t last, Function&& function) {
+			each<Components...>(first, last, NO_FILTERS, 0, function);
+		}
+
+		template<typename... Components, typename Function>
+		void each(const TickFilterVector& filters, Tick since, Function&& function) {
+			each<Components...>(0, size(), filters, since, function);
+		}
+
+		template<typename... Components, typename Function>
+		void each(size_t first, size_t last, const TickFilterVector& filters, Tick since, Function&& function) {
+			blocks<Components...>(first, last, filters, since, [&function](const EntityID* entities, size_t length, Components*... columns) {
+				for (size_t _index{}; _index < length; ++_index) {
+					if constexpr (std::is_invocable_v<Function&, EntityID, Components&...>) {
+						function(entities[_index], element<Components>(columns, _index)...);
+					}
+					else {
+						function(element<Components>(columns, _index)...);
+					}
+				}
+			});
+		}
+
+		template<typename... Components, typename Function>
+		void eachChunk(Function&& function) {
+			eachChunk<Components...>(NO_FILTERS, 0, function);
+		}
+
+		template<typename... Components, typename Function>
+		void eachChunk(const TickFilterVector& filters, Tick since, Function&& function) {
+			static_assert(!(TAG_COMPONENT<std::decay_t<Components>> || ...), "Tag components have no column to yield as a span");
+
+			blocks<Components...>(0, size(), filters, since, [&function](const EntityID* entities, size_t length, Components*... columns) {
+				if constexpr (std::is_invocable_v<Function&, std::span<const EntityID>, std::span<Components>...>) {
+					function(std::span<const EntityID>{ entities, length }, std::span<Components>{ columns, length }...);
+				}
+				else {
+					function(std::span<Components>{ columns, length }...);
+				}
+			});
+		}
+
+		template<typename... Components, typename Function>
+		void blocks(size_t first, size_t last, Function&& function) {
+			blocks<Components...>(first, last, NO_FILTERS, 0, function);
+		}
+
+		template<typename... Components, typename Function>
+		void blocks(size_t first, size_t last, const TickFilterVector& filters, Tick since, Function&& function) {
+			constexpr size_t blockSize{ std::min({
+				Accessor<EntityID>::BLOCK_SIZE, Accessor<std::decay_t<Components>>::BLOCK_SIZE... }) };
+
+			const Accessor<EntityID>& entities{ std::as_const(*this).template accessor<EntityID>() };
+			std::tuple<Accessor<std::decay_t<Components>>*...> columns{ columnOf<Components>()... };
+			std::tuple<TagSlot<std::decay_t<Components>>...> tags;
+
+			auto visit{ [&](size_t _index, size_t length) {
+				function(
+					entities.data(_index),
+					length,
+					rows<Components>(std::get<Accessor<std::decay_t<Components>>*>(columns), _index, std::get<TagSlot<std::decay_t<Components>>>(tags))...);
+
+				(touch<Components>(std::get<Accessor<std::decay_t<Components>>*>(columns), _index, length), ...);
+			} };
+
+			if (filters.empty()) {
+				for (size_t _index{ first }; _index < last;) {
+					size_t length{ std::min(blockSize - _index % blockSize, last - _index) };
+					visit(_index, length);
+					_index += length;
+				}
+				return;
+			}
+
+			std::vector<const TickColumn*> ticks;
+			std::vector<const Tick*> rows;
+			ticks.reserve(filters.size());
+			rows.reserve(filters.size());
+
+			for (const TickFilter& filter : filters) {
+				uint16_t slot{ column(filter.id) };
+				const TickColumn* tickColumn{ slot == NO_COLUMN ? nullptr : _columns[slot]->ticks() };
+
+				if (!tickColumn || tickColumn->max(filter.added) <= since) {
+					return;
+				}
+				ticks.push_back(tickColumn);
+				rows.push_back(tickColumn->rows(filter.added));
+			}
+
+			constexpr size_t window{ std::min(blockSize, TickColumn::BLOCK_SIZE) };
+
+			for (size_t _index{ first }; _index < last;) {
+				size_t end{ std::min(_index - _index % window + window, last) };
+
+				bool stale{ false };
+				for (size_t filter{}; filter < filters.size(); ++filter) {
+					stale = stale || ticks[filter]->block(_index, filters[filter].added) <= since;
+				}
+
+				if (!stale) {
+					size_t run{ _index };
+					for (size_t row{ _index }; row < end; ++row) {
+						bool fresh{ rows[0][row] > since };
+						for (size_t filter{ 1 }; filter < rows.size(); ++filter) {
+							fresh = fresh && rows[filter][row] > since;
+						}
+
+						if (!fresh) {
+							if (run < row) {
+								visit(run, row - run);
+							}
+							run = row + 1;
+						}
+					}
+
+					if (run < end) {
+						visit(run, end - run);
+					}
+				}
+
+				_index = end;
+			}
+		}
+
+		bool passes(const TickFilterVector& filters, Tick since, size_t _index) const {
+			for (const TickFilter& filter : filters) {
+				uint16_t slot{ column(filter.id) };
+				const TickColumn* tickColumn{ slot == NO_COLUMN ? nullptr : _columns[slot]->ticks() };
+
+				if (!tickColumn || tickColumn->rows(filter.added)[_index] <= since) {
+					return false;
+				}
+			}
+			return true;
+		}
+
 		template<typename... Components>
 		Cache<Components...> _cache() {
 			return Cache<Components...>(*this);
 		}
 
+	private:
+		template<typename Component>
+		static void touch(Accessor<std::decay_t<Component>>* column, size_t first, size_t length) {
+			if constexpr (!std::is_const_v<Component> && !TAG_COMPONENT<std::decay_t<Component>>) {
+				column->touch(first, length);
+			}
+		}
+
+		template<typename Component>
+		static Component* rows(Accessor<std::decay_t<Component>>* column, size_t _index, TagSlot<std::decay_t<Component>>& tag) {
+			if constexpr (TAG_COMPONENT<std::decay_t<Component>>) {
+				return &tag.value;
+			}
+			else {
+				return column->data(_index);
+			}
+		}
+
+		template<typename Component>
+		static Component& element(Component* column, size_t _index) {
+			if constexpr (TAG_COMPONENT<std::decay_t<Component>>) {
+				return *column;
+			}
+			else {
+				return column[_index];
+			}
+		}
+
+		// Columns read through const components are not copied out of a shared archetype; only rows() reads through the pointer.
+		template<typename Component>
+		Accessor<std::decay_t<Component>>* columnOf() {
+			if constexpr (TAG_COMPONENT<std::decay_t<Component>>) {
+				return nullptr;
+			}
+			else if constexpr (std::is_const_v<Component>) {
+				return const_cast<Accessor<std::decay_t<Component>>*>(&std::as_const(*this).template accessor<std::decay_t<Component>>());
+			}
+			else {
+				return &accessor<Component>();
+			}
+		}
+
+		template<typename Component>
+		Accessor<Component>& accessor() {
+			return own(_slots[Registry<Component>::id()])->template receive<Component>();
+		}
+
+		template<typename Component>
+		const Accessor<Component>& accessor() const {
+			return _columns[_slots[Registry<Component>::id()]]->template receive<Component>();
+		}
+
+		SAccessor& own(size_t slot) {
+			SAccessor& out{ _columns.at(slot) };
+			if (out.use_count() > 1) {
+				out = out->copy();
+				out->clock(_clock);
+			}
+			return out;
+		}
+
+		void own() {
+			for (size_t slot{}; slot < _columns.size(); ++slot) {
+				own(slot);
+			}
+		}
+
+		// Read-only components leave their column shared with any copies of this archetype.
+		template<typename Component>
+		void own() {
+			if constexpr (!TAG_COMPONENT<std::decay_t<Component>> && !std::is_const_v<Component>) {
+				own(_slots[Registry<std::decay_t<Component>>::id()]);
+			}
+		}
+
+		void setColumn(ComponentID id, UAccessor column) {
+			auto position{ std::lower_bound(_ids.begin(), _ids.end(), id) };
+			size_t slot{ static_cast<size_t>(position - _ids.begin()) };
+
+			if (position != _ids.end() && *position == id) {
+				column->clock(_clock);
+				_columns[slot] = std::move(column);
+			}
+			else {
+				column->clock(_clock);
+				_ids.insert(position, id);
+				_columns.insert(_columns.begin() + slot, std::move(column));
+				rebuildSlots();
+			}
+
+			_signature.set(id);
+		}
+
+		void rebuildSlots() {
+			_slots.assign(_ids.empty() ? 0 : _ids.back() + 1, NO_COLUMN);
+
+			for (size_t slot{}; slot < _ids.size(); ++slot) {
+				_slots[_ids[slot]] = static_cast<uint16_t>(slot);
+			}
+		}
+
+		template<bool WithEntity = false, typename From, typename Function>
+		void join(From& from, Function&& function) {
+			size_t toSlot{};
+			size_t fromSlot{};
+			ComponentID entityID{ Registry<EntityID>::id() };
+
+			while (toSlot < _ids.size() && fromSlot < from._ids.size()) {
+				if (_ids[toSlot] < from._ids[fromSlot]) {
+					++toSlot;
+				}
+				else if (from._ids[fromSlot] < _ids[toSlot]) {
+					++fromSlot;
+				}
+				else {
+					if (WithEntity || _ids[toSlot] != entityID) {
+						function(_columns[toSlot], from._columns[fromSlot]);
+					}
+					++toSlot;
+					++fromSlot;
+				}
+			}
+		}
+
 	};
 
 }
\ No newline at end of file
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <algorithm>
+#include <limits>
+
+// Each file in bench/ is a standalone program; build it on its own with optimizations, e.g.
+//   cl /std:c++20 /O2 /EHsc bench\columns.cpp
+//   g++ -std=c++20 -O2 -pthread bench/columns.cpp
+
+namespace Byte::Bench {
+
+	inline volatile size_t sink{};
+
+	// Keeps a result alive so the measured loop is not optimized away.
+	template<typename Type>
+	void keep(const Type& value) {
+		sink = sink + static_cast<size_t>(value);
+	}
+
+	// Best of repeats, in milliseconds; the minimum is the least noisy estimate of the loop itself.
+	template<typename Function>
+	double measure(Function&& function, size_t repeats = 5) {
+		double best{ std::numeric_limits<double>::max() };
+		for (size_t repeat{}; repeat < repeats; ++repeat) {
+			auto start{ std::chrono::steady_clock::now() };
+			function();
+			auto end{ std::chrono::steady_clock::now() };
+			best = std::min(best, std::chrono::duration<double, std::milli>(end - start).count());
+		}
+		return best;
+	}
+
+	inline void report(const std::string& name, double ms, double baseline = 0.0) {
+		std::cout << std::left << std::setw(40) << name << std::right << std::setw(10) << std::fixed << std::setprecision(3) << ms << " ms";
+		if (baseline > 0.0) {
+			std::cout << std::setw(8) << std::setprecision(2) << baseline / ms << "x";
+		}
+		std::cout << '\n';
+	}
+
+}
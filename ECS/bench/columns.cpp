@@ -0,0 +1,98 @@
+#include "../ecs.h"
+#include "bench.h"
+
+#include <vector>
+#include <random>
+#include <unordered_map>
+
+using namespace Byte;
+
+// Column lookup: the dense slot table in Archetype against the unordered_map<ComponentID, UAccessor> it replaced.
+
+template<size_t N>
+struct Field {
+    float value{ 1.0f };
+};
+
+using Arche = World::Archetype;
+using ColumnMap = std::unordered_map<ComponentID, Arche::UAccessor>;
+
+template<typename Component>
+Component& lookup(ColumnMap& columns, size_t row) {
+    return columns.at(Registry<Component>::id())->template receive<Component>().get(row);
+}
+
+template<typename Component>
+void emplace(ColumnMap& columns, size_t count) {
+    auto column{ std::make_unique<Arche::Accessor<Component>>() };
+    for (size_t row{}; row < count; ++row) {
+        column->pushBack(Component{});
+    }
+    columns.emplace(Registry<Component>::id(), std::move(column));
+}
+
+int main() {
+    constexpr size_t COUNT{ 1 << 18 };
+
+    Arche arche{ Arche::build<Field<0>, Field<1>, Field<2>, Field<3>, Field<4>, Field<5>, Field<6>, Field<7>>() };
+    ColumnMap columns;
+
+    for (size_t row{}; row < COUNT; ++row) {
+        arche.pushEntity(EntityID{ row });
+        arche.pushComponent(Field<0>{});
+        arche.pushComponent(Field<1>{});
+        arche.pushComponent(Field<2>{});
+        arche.pushComponent(Field<3>{});
+        arche.pushComponent(Field<4>{});
+        arche.pushComponent(Field<5>{});
+        arche.pushComponent(Field<6>{});
+        arche.pushComponent(Field<7>{});
+    }
+    emplace<Field<0>>(columns, COUNT);
+    emplace<Field<2>>(columns, COUNT);
+    emplace<Field<5>>(columns, COUNT);
+    emplace<Field<7>>(columns, COUNT);
+
+    std::vector<size_t> rows(COUNT);
+    std::mt19937_64 random{ 7 };
+    for (size_t& row : rows) {
+        row = random() % COUNT;
+    }
+
+    // Random rows so the lookup, not streaming bandwidth, dominates.
+    double mapped{ Bench::measure([&] {
+        float sum{};
+        for (size_t row : rows) {
+            sum += lookup<Field<0>>(columns, row).value + lookup<Field<2>>(columns, row).value
+                + lookup<Field<5>>(columns, row).value + lookup<Field<7>>(columns, row).value;
+        }
+        Bench::keep(sum);
+    }) };
+
+    double table{ Bench::measure([&] {
+        float sum{};
+        for (size_t row : rows) {
+            sum += arche.getComponent<Field<0>>(row).value + arche.getComponent<Field<2>>(row).value
+                + arche.getComponent<Field<5>>(row).value + arche.getComponent<Field<7>>(row).value;
+        }
+        Bench::keep(sum);
+    }) };
+
+    const Arche& view{ arche };
+    double constTable{ Bench::measure([&] {
+        float sum{};
+        for (size_t row : rows) {
+            sum += view.getComponent<Field<0>>(row).value + view.getComponent<Field<2>>(row).value
+                + view.getComponent<Field<5>>(row).value + view.getComponent<Field<7>>(row).value;
+        }
+        Bench::keep(sum);
+    }) };
+
+    // Mutable lookups also pay the copy-on-write ownership check that forks rely on.
+    std::cout << COUNT << " random rows, 4 column lookups each\n";
+    Bench::report("unordered_map<ComponentID, UAccessor>", mapped);
+    Bench::report("slot table", table, mapped);
+    Bench::report("slot table, const", constTable, mapped);
+
+    return 0;
+}
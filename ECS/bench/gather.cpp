@@ -0,0 +1,93 @@
+#include "../ecs.h"
+#include "bench.h"
+
+#include <random>
+#include <vector>
+#include <algorithm>
+
+using namespace Byte;
+
+// Random-access reads by entity id: the entity map's find_batch against a find() loop, and World::gather /
+// gatherGrouped against a get() per component, over ids shuffled so that every lookup misses the cache.
+
+struct Position {
+    float x{}, y{}, z{};
+};
+
+struct Velocity {
+    float x{ 1.0f }, y{ 0.5f }, z{ 0.25f };
+};
+
+struct Mass {
+    float value{ 1.0f };
+};
+
+int main() {
+    constexpr size_t COUNT{ 1 << 20 };
+
+    World world;
+    std::vector<EntityID> ids(COUNT);
+    for (size_t i{}; i < COUNT; ++i) {
+        ids[i] = i % 4 ? world.create(Position{ float(i) }, Velocity{}) : world.create(Position{ float(i) }, Velocity{}, Mass{});
+    }
+
+    std::mt19937_64 engine{ 9 };
+    std::shuffle(ids.begin(), ids.end(), engine);
+    std::cout << COUNT << " entities in 2 archetypes, shuffled ids\n";
+
+    hash_map<EntityID, size_t> map;
+    for (size_t i{}; i < COUNT; ++i) {
+        map.emplace(ids[i], i);
+    }
+
+    double found{ Bench::measure([&] {
+        size_t sum{};
+        for (EntityID id : ids) {
+            sum += map.find(id)->second;
+        }
+        Bench::keep(sum);
+    }) };
+
+    std::vector<size_t*> values(COUNT);
+    double batched{ Bench::measure([&] {
+        map.find_batch(std::span<const EntityID>{ ids }, std::span<size_t*>{ values });
+        size_t sum{};
+        for (size_t* value : values) {
+            sum += *value;
+        }
+        Bench::keep(sum);
+    }) };
+
+    Bench::report("find loop", found);
+    Bench::report("find_batch", batched, found);
+
+    double got{ Bench::measure([&] {
+        float sum{};
+        for (EntityID id : ids) {
+            sum += world.get<const Position>(id).x + world.get<const Velocity>(id).x;
+        }
+        Bench::keep(sum);
+    }) };
+
+    double gathered{ Bench::measure([&] {
+        float sum{};
+        world.gather<const Position, const Velocity>(ids, [&](const Position& position, const Velocity& velocity) {
+            sum += position.x + velocity.x;
+        });
+        Bench::keep(sum);
+    }) };
+
+    double grouped{ Bench::measure([&] {
+        float sum{};
+        world.gatherGrouped<const Position, const Velocity>(ids, [&](const Position& position, const Velocity& velocity) {
+            sum += position.x + velocity.x;
+        });
+        Bench::keep(sum);
+    }) };
+
+    Bench::report("get<Position> + get<Velocity>", got);
+    Bench::report("gather", gathered, got);
+    Bench::report("gatherGrouped", grouped, got);
+
+    return 0;
+}
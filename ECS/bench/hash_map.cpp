@@ -0,0 +1,98 @@
+#include "../hash_map.h"
+#include "bench.h"
+
+#include <cstdint>
+#include <random>
+#include <vector>
+#include <algorithm>
+#include <unordered_map>
+
+using namespace Byte;
+
+// group_probe against the double_hash_probe it replaced as the entity map, and std::unordered_map.
+// The erase column churns a quarter of the keys; double_hash_probe only reclaims erased slots on a rehash,
+// so its probe chains lengthen as the churn repeats.
+
+using Key = uint64_t;
+
+template<typename Probe>
+using Map = hash_map<Key, uint64_t, std::hash<Key>, std::equal_to<Key>, Probe>;
+using Std = std::unordered_map<Key, uint64_t>;
+
+template<typename MapType>
+uint64_t* lookup(MapType& map, Key key) {
+    auto result{ map.find(key) };
+    return result == map.end() ? nullptr : &result->second;
+}
+
+template<typename MapType>
+void suite(const char* name, const std::vector<Key>& keys, const std::vector<Key>& misses, size_t erases) {
+    double count{ static_cast<double>(keys.size()) };
+    MapType map;
+
+    double insert{ Bench::measure([&] {
+        map = MapType{};
+        for (Key key : keys) {
+            map.emplace(key, key);
+        }
+    }) };
+
+    double hit{ Bench::measure([&] {
+        uint64_t sum{};
+        for (Key key : keys) {
+            sum += *lookup(map, key);
+        }
+        Bench::keep(sum);
+    }) };
+
+    double miss{ Bench::measure([&] {
+        size_t found{};
+        for (Key key : misses) {
+            found += lookup(map, key) != nullptr;
+        }
+        Bench::keep(found);
+    }) };
+
+    double erase{ Bench::measure([&] {
+        for (size_t idx{}; idx < erases; ++idx) {
+            map.erase(keys[idx]);
+        }
+        for (size_t idx{}; idx < erases; ++idx) {
+            map.emplace(keys[idx], keys[idx]);
+        }
+    }, 3) };
+
+    auto ns{ [](double ms, double operations) {
+        return ms * 1e6 / operations;
+    } };
+
+    std::cout << std::left << std::setw(24) << name << std::right << std::fixed << std::setprecision(1)
+        << std::setw(10) << ns(insert, count)
+        << std::setw(10) << ns(hit, count)
+        << std::setw(10) << ns(miss, static_cast<double>(misses.size()))
+        << std::setw(14) << ns(erase, 2.0 * erases) << '\n';
+}
+
+int main() {
+    constexpr size_t COUNT{ 1 << 20 };
+
+    std::mt19937_64 engine{ 5 };
+    std::vector<Key> keys(COUNT);
+    std::vector<Key> misses(COUNT);
+    for (Key& key : keys) {
+        key = engine() | 1;
+    }
+    for (Key& key : misses) {
+        key = engine() & ~Key{ 1 };
+    }
+
+    std::cout << COUNT << " random 64-bit keys, ns per operation\n";
+    std::cout << std::left << std::setw(24) << "" << std::right << std::setw(10) << "insert" << std::setw(10) << "hit"
+        << std::setw(10) << "miss" << std::setw(14) << "erase+insert" << '\n';
+
+    suite<Std>("std::unordered_map", keys, misses, COUNT / 4);
+    suite<Map<double_hash_probe>>("double_hash_probe", keys, misses, COUNT / 4);
+    suite<Map<group_probe>>("group_probe", keys, misses, COUNT / 4);
+
+    return 0;
+}
@@ -0,0 +1,79 @@
+#include "../ecs.h"
+#include "bench.h"
+
+#include <vector>
+
+using namespace Byte;
+
+// View::each against the range-for iterator path, with a plain loop over two vectors as the floor.
+
+struct Position {
+    float x{}, y{};
+};
+
+struct Velocity {
+    float x{ 1.0f }, y{ 1.0f };
+};
+
+struct Health {
+    int value{ 100 };
+};
+
+int main() {
+    constexpr size_t COUNT{ 1 << 20 };
+
+    World world;
+    for (size_t i{}; i < COUNT; ++i) {
+        // Four archetypes, so both paths cross archetype boundaries.
+        switch (i % 4) {
+        case 0: world.create(Position{}, Velocity{}); break;
+        case 1: world.create(Position{}, Velocity{}, Health{}); break;
+        case 2: world.create(Position{}, Velocity{}, 1); break;
+        default: world.create(Position{}, Velocity{}, Health{}, 1.0); break;
+        }
+    }
+
+    std::vector<Position> positions(COUNT);
+    std::vector<Velocity> velocities(COUNT);
+
+    double raw{ Bench::measure([&] {
+        for (size_t i{}; i < COUNT; ++i) {
+            positions[i].x += velocities[i].x;
+            positions[i].y += velocities[i].y;
+        }
+    }) };
+    Bench::keep(positions[COUNT / 2].x);
+
+    auto view{ world.components<Position, const Velocity>() };
+
+    double iterated{ Bench::measure([&] {
+        for (auto [position, velocity] : view) {
+            position.x += velocity.x;
+            position.y += velocity.y;
+        }
+    }) };
+
+    double each{ Bench::measure([&] {
+        view.each([](Position& position, const Velocity& velocity) {
+            position.x += velocity.x;
+            position.y += velocity.y;
+        });
+    }) };
+
+    double chunked{ Bench::measure([&] {
+        view.eachChunk([](std::span<Position> positions, std::span<const Velocity> velocities) {
+            for (size_t i{}; i < positions.size(); ++i) {
+                positions[i].x += velocities[i].x;
+                positions[i].y += velocities[i].y;
+            }
+        });
+    }) };
+
+    std::cout << COUNT << " entities, 4 archetypes, position += velocity\n";
+    Bench::report("range-for", iterated);
+    Bench::report("each", each, iterated);
+    Bench::report("eachChunk", chunked, iterated);
+    Bench::report("std::vector loop", raw, iterated);
+
+    return 0;
+}
@@ -0,0 +1,131 @@
+#include "../ecs.h"
+#include "bench.h"
+
+#include <random>
+#include <vector>
+#include <utility>
+
+using namespace Byte;
+
+// Archetype matching: Signature::includes against a scalar word loop, and views resolved through the
+// component-to-archetype index against a scan of every archetype signature.
+
+using Sig = World::Signature;
+
+template<size_t N>
+struct Field {
+    int value{};
+};
+
+struct Rare {
+    int value{};
+};
+
+bool scalarIncludes(const Sig& left, const Sig& right) {
+    for (size_t word{}; word < Sig::BITSET_COUNT; ++word) {
+        if (right.data()[word] & ~left.data()[word]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template<size_t... Indices>
+void createMasked(World& world, size_t mask, std::index_sequence<Indices...>) {
+    EntityID id{ world.create(Field<0>{}) };
+    ((mask >> Indices & 1 ? world.attach(id, Field<Indices + 1>{}) : void()), ...);
+    if (mask % 512 == 0) {
+        world.attach(id, Rare{});
+    }
+}
+
+template<typename... Components>
+void compare(World& world, const std::vector<World::Archetype*>& all, const char* name) {
+    Sig query{ Sig::build<EntityID, Components...>() };
+
+    double scanned{ Bench::measure([&] {
+        for (size_t repeat{}; repeat < 100; ++repeat) {
+            size_t out{};
+            for (World::Archetype* arche : all) {
+                out += arche->signature().includes(query);
+            }
+            Bench::keep(out);
+        }
+    }) };
+
+    double indexed{ Bench::measure([&] {
+        for (size_t repeat{}; repeat < 100; ++repeat) {
+            Bench::keep(world.components<Components...>().archetypes().size());
+        }
+    }) };
+
+    std::cout << name << ", " << world.components<Components...>().archetypes().size() << " matches, 100 views\n";
+    Bench::report("  scan every archetype", scanned);
+    Bench::report("  component index", indexed, scanned);
+}
+
+int main() {
+    constexpr size_t TYPES{ 12 };
+
+    std::mt19937_64 engine{ 3 };
+    std::vector<Sig> signatures(1 << 16);
+    for (Sig& signature : signatures) {
+        for (size_t bit{}; bit < 6; ++bit) {
+            signature.set(static_cast<ComponentID>(engine() % 96));
+        }
+    }
+    std::cout << "includes() over " << signatures.size() << " signatures x 16, " << Sig::MAX_COMPONENT_COUNT << " bits\n";
+
+    // Most archetypes fail a query in the first word; matches have to look at every word.
+    Sig rejected;
+    rejected.set(1);
+    rejected.set(5);
+
+    Sig accepted;
+    accepted.set(3);
+    accepted.set(517);
+    accepted.set(1000);
+    std::vector<Sig> supersets{ signatures };
+    for (Sig& signature : supersets) {
+        signature += accepted;
+    }
+
+    auto time{ [](const std::vector<Sig>& haystack, const Sig& query, auto includes) {
+        return Bench::measure([&] {
+            size_t out{};
+            for (size_t repeat{}; repeat < 16; ++repeat) {
+                for (const Sig& signature : haystack) {
+                    out += includes(signature, query);
+                }
+            }
+            Bench::keep(out);
+        });
+    } };
+    auto simd{ [](const Sig& left, const Sig& right) {
+        return left.includes(right);
+    } };
+
+    double scalarRejected{ time(signatures, rejected, scalarIncludes) };
+    double scalarAccepted{ time(supersets, accepted, scalarIncludes) };
+    std::cout << "  mostly rejected\n";
+    Bench::report("    scalar words", scalarRejected);
+    Bench::report("    Signature::includes", time(signatures, rejected, simd), scalarRejected);
+    std::cout << "  all accepted\n";
+    Bench::report("    scalar words", scalarAccepted);
+    Bench::report("    Signature::includes", time(supersets, accepted, simd), scalarAccepted);
+
+    World world;
+    for (size_t mask{}; mask < (size_t{ 1 } << TYPES); ++mask) {
+        createMasked(world, mask, std::make_index_sequence<TYPES>{});
+    }
+
+    // A view over EntityID alone matches every non-empty archetype.
+    std::vector<World::Archetype*> all{ world.components<EntityID>().archetypes() };
+    std::cout << '\n' << all.size() << " archetypes\n";
+
+    compare<Field<3>, Field<7>>(world, all, "common pair");
+    compare<Field<1>, Field<2>, Field<3>, Field<4>, Field<5>>(world, all, "five components");
+    compare<Rare>(world, all, "rare component");
+
+    return 0;
+}
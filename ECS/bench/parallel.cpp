@@ -0,0 +1,76 @@
+#include "../ecs.h"
+#include "bench.h"
+
+#include <cmath>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace Byte;
+
+// View::parallelEach scaling over thread counts and grain sizes, against a serial each().
+
+struct Position {
+    float x{}, y{}, z{};
+};
+
+struct Velocity {
+    float x{ 1.0f }, y{ 0.5f }, z{ 0.25f };
+};
+
+// Enough arithmetic per row that the loop is compute-bound and can scale past memory bandwidth.
+void integrate(Position& position, const Velocity& velocity) {
+    for (int step{}; step < 8; ++step) {
+        float length{ std::sqrt(position.x * position.x + position.y * position.y + position.z * position.z) + 1.0f };
+        position.x += velocity.x / length;
+        position.y += velocity.y / length;
+        position.z += velocity.z / length;
+    }
+}
+
+int main() {
+    constexpr size_t COUNT{ 1 << 20 };
+
+    World world;
+    for (size_t i{}; i < COUNT; ++i) {
+        if (i % 3) {
+            world.create(Position{}, Velocity{});
+        }
+        else {
+            world.create(Position{}, Velocity{}, 1);
+        }
+    }
+
+    auto view{ world.components<Position, const Velocity>() };
+
+    double serial{ Bench::measure([&] {
+        view.each(integrate);
+    }) };
+
+    size_t hardware{ std::max<size_t>(1, std::thread::hardware_concurrency()) };
+    std::cout << COUNT << " entities, " << hardware << " hardware threads\n";
+    Bench::report("each", serial);
+
+    std::vector<size_t> threads{ 1, 2, 4, 8, 16 };
+    for (size_t count : threads) {
+        if (count > hardware * 2) {
+            break;
+        }
+
+        world.threadPool(std::make_shared<ThreadPool>(count));
+        for (size_t grain : { size_t{ 256 }, size_t{ 4096 }, size_t{ 65536 } }) {
+            double parallel{ Bench::measure([&] {
+                view.parallelEach(integrate, grain);
+            }) };
+            Bench::report("parallelEach " + std::to_string(count) + " threads, grain " + std::to_string(grain), parallel, serial);
+        }
+    }
+
+    float sum{};
+    world.components<const Position>().each([&](const Position& position) {
+        sum += position.x;
+    });
+    Bench::keep(sum);
+
+    return 0;
+}
@@ -0,0 +1,143 @@
+#include "../ecs.h"
+#include "bench.h"
+
+#include <cstdint>
+#include <span>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BYTE_BENCH_SSE
+#include <immintrin.h>
+#endif
+
+using namespace Byte;
+
+// Example SIMD kernels over eachChunk spans: particle integration, position += velocity * dt.
+// AlignedWorld columns start on 64-byte boundaries, so the kernels can use aligned loads there;
+// World gets the same kernels with unaligned loads. Build with /arch:AVX2 or -mavx2 to include the AVX kernel.
+
+struct alignas(16) Position {
+    float x{}, y{}, z{}, w{};
+};
+
+struct alignas(16) Velocity {
+    float x{ 1.0f }, y{ 2.0f }, z{ 3.0f }, w{};
+};
+
+inline constexpr float DT{ 1.0f / 60.0f };
+
+void scalar(std::span<Position> positions, std::span<const Velocity> velocities) {
+    for (size_t i{}; i < positions.size(); ++i) {
+        positions[i].x += velocities[i].x * DT;
+        positions[i].y += velocities[i].y * DT;
+        positions[i].z += velocities[i].z * DT;
+    }
+}
+
+#if defined(BYTE_BENCH_SSE)
+// One particle per 128-bit register; w is padding and stays zero because velocity.w is zero.
+template<bool Aligned>
+void sse(std::span<Position> positions, std::span<const Velocity> velocities) {
+    float* position{ &positions.data()->x };
+    const float* velocity{ &velocities.data()->x };
+    __m128 dt{ _mm_set1_ps(DT) };
+
+    for (size_t i{}; i < positions.size() * 4; i += 4) {
+        if constexpr (Aligned) {
+            _mm_store_ps(position + i, _mm_add_ps(_mm_load_ps(position + i), _mm_mul_ps(_mm_load_ps(velocity + i), dt)));
+        }
+        else {
+            _mm_storeu_ps(position + i, _mm_add_ps(_mm_loadu_ps(position + i), _mm_mul_ps(_mm_loadu_ps(velocity + i), dt)));
+        }
+    }
+}
+#endif
+
+#if defined(__AVX__)
+// Two particles per 256-bit register, with an SSE step for an odd tail.
+template<bool Aligned>
+void avx(std::span<Position> positions, std::span<const Velocity> velocities) {
+    float* position{ &positions.data()->x };
+    const float* velocity{ &velocities.data()->x };
+    size_t floats{ positions.size() * 4 };
+    __m256 dt{ _mm256_set1_ps(DT) };
+
+    size_t i{};
+    for (; i + 8 <= floats; i += 8) {
+        if constexpr (Aligned) {
+            _mm256_store_ps(position + i, _mm256_add_ps(_mm256_load_ps(position + i), _mm256_mul_ps(_mm256_load_ps(velocity + i), dt)));
+        }
+        else {
+            _mm256_storeu_ps(position + i, _mm256_add_ps(_mm256_loadu_ps(position + i), _mm256_mul_ps(_mm256_loadu_ps(velocity + i), dt)));
+        }
+    }
+    if (i < floats) {
+        _mm_storeu_ps(position + i, _mm_add_ps(_mm_loadu_ps(position + i), _mm_mul_ps(_mm_loadu_ps(velocity + i), _mm256_castps256_ps128(dt))));
+    }
+}
+#endif
+
+template<typename WorldType>
+void alignment(WorldType& world, const char* name) {
+    size_t spans{};
+    size_t misaligned{};
+    world.template components<Position, const Velocity>().eachChunk([&](std::span<Position> positions, std::span<const Velocity> velocities) {
+        spans += 2;
+        misaligned += reinterpret_cast<uintptr_t>(positions.data()) % 64 != 0;
+        misaligned += reinterpret_cast<uintptr_t>(velocities.data()) % 64 != 0;
+    });
+    std::cout << name << ": " << misaligned << " of " << spans << " column spans not 64-byte aligned\n";
+}
+
+template<typename WorldType, typename Kernel>
+double run(WorldType& world, Kernel kernel, size_t passes) {
+    auto view{ world.template components<Position, const Velocity>() };
+    return Bench::measure([&] {
+        for (size_t pass{}; pass < passes; ++pass) {
+            view.eachChunk(kernel);
+        }
+    }, 9);
+}
+
+template<typename WorldType, bool Aligned>
+void suite(const char* name, size_t count, size_t passes) {
+    WorldType world;
+    for (size_t i{}; i < count; ++i) {
+        // A second archetype gives eachChunk more than one span per column.
+        if (i % 2) {
+            world.create(Position{}, Velocity{});
+        }
+        else {
+            world.create(Position{}, Velocity{}, 1);
+        }
+    }
+
+    alignment(world, name);
+
+    double base{ run(world, scalar, passes) };
+    Bench::report("  scalar", base);
+#if defined(BYTE_BENCH_SSE)
+    Bench::report(Aligned ? "  sse, aligned loads" : "  sse, unaligned loads", run(world, sse<Aligned>, passes), base);
+#endif
+#if defined(__AVX__)
+    Bench::report(Aligned ? "  avx, aligned loads" : "  avx, unaligned loads", run(world, avx<Aligned>, passes), base);
+#endif
+
+    float sum{};
+    world.template components<const Position>().each([&](const Position& position) {
+        sum += position.x;
+    });
+    Bench::keep(sum);
+}
+
+int main() {
+    // 8192 particles stay in L2, so the kernels are compute-bound; 1M particles measure memory bandwidth instead.
+    std::cout << "8192 particles x 128 passes, position += velocity * dt\n";
+    suite<World, false>("World", 8192, 128);
+    suite<AlignedWorld, true>("AlignedWorld", 8192, 128);
+
+    std::cout << "\n1048576 particles x 1 pass\n";
+    suite<World, false>("World", 1 << 20, 1);
+    suite<AlignedWorld, true>("AlignedWorld", 1 << 20, 1);
+
+    return 0;
+}
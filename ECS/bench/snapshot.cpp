@@ -0,0 +1,75 @@
+#include "../ecs.h"
+#include "bench.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+
+using namespace Byte;
+
+// World::load from a snapshot against rebuilding the same world entity by entity, and save/load throughput.
+// Pass an entity count to override the default, e.g. 10000000 for the restart-sized world.
+
+struct Position {
+    float x{}, y{}, z{};
+};
+
+struct Velocity {
+    float x{ 1.0f }, y{ 0.5f }, z{ 0.25f };
+};
+
+struct Health {
+    int value{ 100 };
+};
+
+World build(size_t count) {
+    World world;
+    for (size_t i{}; i < count; ++i) {
+        if (i % 4) {
+            world.create(Position{ float(i) }, Velocity{});
+        }
+        else {
+            world.create(Position{ float(i) }, Velocity{}, Health{});
+        }
+    }
+    return world;
+}
+
+int main(int argc, char** argv) {
+    size_t count{ argc > 1 ? std::strtoull(argv[1], nullptr, 10) : size_t{ 1 } << 21 };
+    std::string path{ (std::filesystem::temp_directory_path() / "byte_ecs_snapshot.bin").string() };
+
+    World::serializable<Position, Velocity, Health>();
+
+    double rebuilt{ Bench::measure([&] {
+        Bench::keep(build(count).components<const Position>().archetypes().size());
+    }, 3) };
+
+    World world{ build(count) };
+    double saved{ Bench::measure([&] {
+        world.save(path);
+    }, 3) };
+
+    double megabytes{ static_cast<double>(std::filesystem::file_size(path)) / (1024.0 * 1024.0) };
+
+    double loaded{ Bench::measure([&] {
+        World out{ World::load(path) };
+        Bench::keep(out.components<const Position>().archetypes().size());
+    }, 3) };
+
+    double copied{ Bench::measure([&] {
+        World out{ world.copy() };
+        Bench::keep(out.components<const Position>().archetypes().size());
+    }, 3) };
+
+    std::cout << count << " entities, " << std::fixed << std::setprecision(1) << megabytes << " MB snapshot\n";
+    Bench::report("rebuild with create()", rebuilt);
+    Bench::report("World::load", loaded, rebuilt);
+    Bench::report("World::copy (shares columns)", copied, rebuilt);
+    Bench::report("World::save", saved);
+    std::cout << "load " << megabytes * 1000.0 / loaded << " MB/s, save " << megabytes * 1000.0 / saved << " MB/s\n";
+
+    std::remove(path.c_str());
+    return 0;
+}
@@ -0,0 +1,215 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <new>
+#include <utility>
+#include <bit>
+#include <algorithm>
+#include <stdexcept>
+
+namespace Byte {
+
+	template<typename _Type, size_t _CHUNK_BYTES = 16384, size_t _ALIGNMENT = 64>
+	class chunk_vector {
+	public:
+		using value_type = _Type;
+		using size_type = size_t;
+		using reference = value_type&;
+		using const_reference = const value_type&;
+
+		inline static constexpr size_t chunk_bytes{ _CHUNK_BYTES };
+		inline static constexpr size_t chunk_size{
+			std::bit_floor(std::max<size_t>(1, chunk_bytes / sizeof(value_type))) };
+		inline static constexpr size_t chunk_shift{ static_cast<size_t>(std::countr_zero(chunk_size)) };
+		inline static constexpr size_t chunk_mask{ chunk_size - 1 };
+		inline static constexpr size_t alignment{ std::max(_ALIGNMENT, alignof(value_type)) };
+
+	private:
+		struct alignas(value_type) slot {
+			std::byte data[sizeof(value_type)];
+		};
+
+		struct chunk_deleter {
+			void operator()(slot* pointer) const {
+				::operator delete(pointer, std::align_val_t{ alignment });
+			}
+		};
+
+		using chunk = std::unique_ptr<slot[], chunk_deleter>;
+		using chunk_list = std::vector<chunk>;
+
+		chunk_list _chunks;
+		size_t _size{};
+
+	public:
+		chunk_vector() = default;
+
+		chunk_vector(const chunk_vector& left) {
+			append(left);
+		}
+
+		chunk_vector(chunk_vector&& right) noexcept
+			: _chunks{ std::move(right._chunks) }, _size{ std::exchange(right._size, 0) } {
+		}
+
+		chunk_vector& operator=(const chunk_vector& left) {
+			if (this != &left) {
+				clear();
+				append(left);
+			}
+			return *this;
+		}
+
+		chunk_vector& operator=(chunk_vector&& right) noexcept {
+			if (this != &right) {
+				clear();
+				_chunks = std::move(right._chunks);
+				_size = std::exchange(right._size, 0);
+			}
+			return *this;
+		}
+
+		~chunk_vector() {
+			clear();
+		}
+
+		reference operator[](size_t _index) {
+			return *address(_index);
+		}
+
+		const_reference operator[](size_t _index) const {
+			return *address(_index);
+		}
+
+		reference at(size_t _index) {
+			if (_index >= _size) {
+				throw std::out_of_range("chunk_vector index out of range");
+			}
+			return *address(_index);
+		}
+
+		const_reference at(size_t _index) const {
+			if (_index >= _size) {
+				throw std::out_of_range("chunk_vector index out of range");
+			}
+			return *address(_index);
+		}
+
+		reference back() {
+			return *address(_size - 1);
+		}
+
+		const_reference back() const {
+			return *address(_size - 1);
+		}
+
+		void push_back(const value_type& value) {
+			emplace_back(value);
+		}
+
+		void push_back(value_type&& value) {
+			emplace_back(std::move(value));
+		}
+
+		template<typename... _Args>
+		reference emplace_back(_Args&&... args) {
+			if (_size == capacity()) {
+				_chunks.push_back(allocate_chunk());
+			}
+
+			value_type* out{ new (raw_address(_size)) value_type(std::forward<_Args>(args)...) };
+			++_size;
+			return *out;
+		}
+
+		void append(const value_type* values, size_t count) {
+			reserve(_size + count);
+
+			while (count) {
+				size_t length{ std::min(chunk_size - (_size & chunk_mask), count) };
+				std::uninitialized_copy_n(values, length, static_cast<value_type*>(raw_address(_size)));
+
+				_size += length;
+				values += length;
+				count -= length;
+			}
+		}
+
+		void append(const chunk_vector& values) {
+			reserve(_size + values._size);
+
+			for (size_t chunk_index{}; chunk_index < values.chunk_count(); ++chunk_index) {
+				append(values.chunk_data(chunk_index), std::min(chunk_size, values._size - (chunk_index << chunk_shift)));
+			}
+		}
+
+		void pop_back() {
+			--_size;
+			std::destroy_at(address(_size));
+			check_shrink();
+		}
+
+		size_t size() const {
+			return _size;
+		}
+
+		bool empty() const {
+			return _size == 0;
+		}
+
+		size_t capacity() const {
+			return _chunks.size() * chunk_size;
+		}
+
+		void reserve(size_t new_capacity) {
+			_chunks.reserve((new_capacity + chunk_mask) >> chunk_shift);
+			while (capacity() < new_capacity) {
+				_chunks.push_back(allocate_chunk());
+			}
+		}
+
+		void clear() {
+			for (size_t idx{}; idx < _size; ++idx) {
+				std::destroy_at(address(idx));
+			}
+			_size = 0;
+		}
+
+		void shrink_to_fit() {
+			_chunks.resize((_size + chunk_mask) >> chunk_shift);
+		}
+
+		size_t chunk_count() const {
+			return (_size + chunk_mask) >> chunk_shift;
+		}
+
+		value_type* chunk_data(size_t chunk_index) {
+			return std::launder(reinterpret_cast<value_type*>(_chunks[chunk_index].get()));
+		}
+
+		const value_type* chunk_data(size_t chunk_index) const {
+			return std::launder(reinterpret_cast<const value_type*>(_chunks[chunk_index].get()));
+		}
+
+	private:
+		static chunk allocate_chunk() {
+			return chunk{ static_cast<slot*>(::operator new(chunk_size * sizeof(slot), std::align_val_t{ alignment })) };
+		}
+
+		void* raw_address(size_t _index) const {
+			return _chunks[_index >> chunk_shift][_index & chunk_mask].data;
+		}
+
+		value_type* address(size_t _index) const {
+			return std::launder(reinterpret_cast<value_type*>(raw_address(_index)));
+		}
+
+		void check_shrink() {
+			if (capacity() >= _size + 2 * chunk_size) {
+				_chunks.pop_back();
+			}
+		}
+	};
+
+}
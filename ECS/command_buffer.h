@@ -0,0 +1,225 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <type_traits>
+#include <stdexcept>
+#include <cstdint>
+
+#include "component.h"
+
+namespace Byte {
+
+	template<typename WorldType>
+	class CommandBuffer {
+	public:
+		using World = WorldType;
+		using EntityID = typename World::EntityID;
+		using EntityIDGenerator = typename World::EntityIDGenerator;
+		using Archetype = typename World::Archetype;
+		using UAccessor = typename Archetype::UAccessor;
+
+		enum class CommandType : uint8_t {
+			CREATE,
+			DESTROY,
+			ATTACH,
+			DETACH
+		};
+
+		class IPayload {
+		public:
+			virtual ~IPayload() = default;
+
+			virtual void push(Archetype& arche) = 0;
+
+			virtual void assign(Archetype& arche, size_t _index) = 0;
+
+			virtual UAccessor accessor(std::pmr::memory_resource* resource) const = 0;
+
+			virtual void attach(World& world, EntityID id) = 0;
+		};
+
+		template<typename Component>
+		class Payload : public IPayload {
+		private:
+			Component component;
+
+		public:
+			template<typename... Args>
+			Payload(Args&&... args)
+				: component(std::forward<Args>(args)...) {
+			}
+
+			void push(Archetype& arche) override {
+				arche.pushComponent(std::move(component));
+			}
+
+			void assign(Archetype& arche, size_t _index) override {
+				if constexpr (!TAG_COMPONENT<Component>) {
+					arche.template getComponent<Component>(_index) = std::move(component);
+				}
+			}
+
+			UAccessor accessor(std::pmr::memory_resource* resource) const override {
+				if constexpr (TAG_COMPONENT<Component>) {
+					return nullptr;
+				}
+				else {
+					return std::make_unique<typename Archetype::template Accessor<Component>>(resource);
+				}
+			}
+
+			void attach(World& world, EntityID id) override {
+				world.attach(id, std::move(component));
+			}
+		};
+
+		using UPayload = std::unique_ptr<IPayload>;
+
+		struct Command {
+			CommandType type;
+			EntityID entity;
+			ComponentID component{};
+			UPayload payload;
+			bool sparse{ false };
+		};
+
+		using CommandVector = std::vector<Command>;
+
+	private:
+		inline static std::mutex _generatorMutex;
+
+		CommandVector _commands;
+		World* _world{ nullptr };
+
+	public:
+		CommandBuffer() = default;
+
+		explicit CommandBuffer(World& world)
+			: _world{ &world } {
+		}
+
+		EntityID create() {
+			EntityID id{ generate() };
+			_commands.push_back(Command{ CommandType::CREATE, id, ComponentID{}, nullptr, false });
+			return id;
+		}
+
+		template<typename Component, typename... Components>
+		EntityID create(Component&& component, Components&&... components) {
+			EntityID out{ create() };
+			attach(out, std::forward<Component>(component));
+			(attach(out, std::forward<Components>(components)), ...);
+			return out;
+		}
+
+		void destroy(EntityID id) {
+			_commands.push_back(Command{ CommandType::DESTROY, id, ComponentID{}, nullptr, false });
+		}
+
+		template<typename Component>
+		void attach(EntityID id, Component&& component) {
+			using Decayed = std::decay_t<Component>;
+
+			_commands.push_back(Command{
+				CommandType::ATTACH,
+				id,
+				Registry<Decayed>::id(),
+				std::make_unique<Payload<Decayed>>(std::forward<Component>(component)),
+				SPARSE_STORAGE<Decayed> });
+		}
+
+		template<typename Component>
+		void detach(EntityID id) {
+			using Decayed = std::decay_t<Component>;
+
+			_commands.push_back(Command{ CommandType::DETACH, id, Registry<Decayed>::id(), nullptr, SPARSE_STORAGE<Decayed> });
+		}
+
+		CommandVector& commands() {
+			return _commands;
+		}
+
+		size_t size() const {
+			return _commands.size();
+		}
+
+		bool empty() const {
+			return _commands.empty();
+		}
+
+		// Drops the recorded commands; ids reserved by create() go back to the world, as no entity was made for them.
+		void clear() {
+			if constexpr (!STATIC_GENERATOR) {
+				for (const Command& command : _commands) {
+					if (command.type == CommandType::CREATE) {
+						_world->releaseEntity(command.entity);
+					}
+				}
+			}
+			_commands.clear();
+		}
+
+	private:
+		inline static constexpr bool STATIC_GENERATOR{ requires { EntityIDGenerator::generate(); } };
+
+		EntityID generate() {
+			if constexpr (STATIC_GENERATOR) {
+				std::lock_guard<std::mutex> lock{ _generatorMutex };
+				return EntityIDGenerator::generate();
+			}
+			else {
+				if (!_world) {
+					throw std::logic_error("CommandBuffer needs a World to create entities");
+				}
+				return _world->reserveEntity();
+			}
+		}
+	};
+
+	template<typename WorldType>
+	class ParallelCommandBuffer {
+	public:
+		using Buffer = CommandBuffer<WorldType>;
+		using BufferVector = std::vector<std::unique_ptr<Buffer>>;
+
+	private:
+		std::mutex _mutex;
+		std::unordered_map<std::thread::id, Buffer*> _locals;
+		BufferVector _buffers;
+		WorldType* _world{ nullptr };
+
+	public:
+		ParallelCommandBuffer() = default;
+
+		explicit ParallelCommandBuffer(WorldType& world)
+			: _world{ &world } {
+		}
+
+		Buffer& local() {
+			std::lock_guard<std::mutex> lock{ _mutex };
+
+			Buffer*& out{ _locals[std::this_thread::get_id()] };
+			if (!out) {
+				_buffers.push_back(_world ? std::make_unique<Buffer>(*_world) : std::make_unique<Buffer>());
+				out = _buffers.back().get();
+			}
+			return *out;
+		}
+
+		BufferVector& buffers() {
+			return _buffers;
+		}
+
+		void clear() {
+			for (auto& buffer : _buffers) {
+				buffer->clear();
+			}
+		}
+	};
+
+}
\ No newline at end of file
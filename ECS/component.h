@@ -1,21 +1,72 @@
 #pragma once
 
 #include <cstdint>
+#include <vector>
+#include <type_traits>
+#include <string_view>
+#include <algorithm>
+#include <stdexcept>
 
 namespace Byte {
 
 	using ComponentID = uint32_t;
+	using ComponentKey = uint64_t;
+
+	template<typename Component>
+	constexpr std::string_view typeSignature() {
+#if defined(_MSC_VER)
+		return __FUNCSIG__;
+#else
+		return __PRETTY_FUNCTION__;
+#endif
+	}
+
+	template<typename Component>
+	inline constexpr std::string_view COMPONENT_NAME{ typeSignature<Component>() };
+
+	constexpr ComponentKey hashName(std::string_view name) {
+		ComponentKey out{ 0xCBF29CE484222325ull };
+		for (char character : name) {
+			out = (out ^ static_cast<uint8_t>(character)) * 0x100000001B3ull;
+		}
+		return out;
+	}
 
 	class ComponentIDGenerator {
 	private:
 		inline static ComponentID nextID{ 0 };
 
+		static std::vector<ComponentKey>& keys() {
+			static std::vector<ComponentKey> out;
+			return out;
+		}
+
 	public:
 		template<typename Component>
 		static ComponentID generate() {
+			assign(nextID, hashName(COMPONENT_NAME<Component>));
 			return nextID++;
 		}
 
+		static void assign(ComponentID id, ComponentKey key) {
+			if (id >= keys().size()) {
+				keys().resize(id + 1);
+			}
+			keys()[id] = key;
+		}
+
+		static ComponentKey key(ComponentID id) {
+			return keys().at(id);
+		}
+
+		static ComponentID find(ComponentKey key) {
+			auto result{ std::find(keys().begin(), keys().end(), key) };
+			if (result == keys().end()) {
+				throw std::out_of_range("Unknown component key");
+			}
+			return static_cast<ComponentID>(result - keys().begin());
+		}
+
 	};
 
 	template<typename Component>
@@ -28,10 +79,55 @@ namespace Byte {
 			return _id;
 		}
 
+		static ComponentKey key() {
+			return hashName(COMPONENT_NAME<Component>);
+		}
+
 		static void set(ComponentID newID) {
 			_id = newID;
+			ComponentIDGenerator::assign(newID, key());
 		}
 
 	};
 
+	template<typename Component>
+	inline constexpr bool SPARSE_STORAGE{ false };
+
+	template<typename Component>
+	inline constexpr bool TAG_COMPONENT{ std::is_empty_v<Component> };
+
+	// Tags have no column; views hand each visit a tag object from one of these, held by the caller, instead of shared storage.
+	template<typename Component, bool = TAG_COMPONENT<Component>>
+	struct TagSlot {
+		Component value{};
+	};
+
+	template<typename Component>
+	struct TagSlot<Component, false> {
+	};
+
+	using Tick = uint32_t;
+
+	template<typename Component>
+	inline constexpr bool TRACK_CHANGES{ false };
+
+	template<typename Component>
+	struct Added {
+		using Type = Component;
+		inline static constexpr bool ADDED{ true };
+	};
+
+	template<typename Component>
+	struct Changed {
+		using Type = Component;
+		inline static constexpr bool ADDED{ false };
+	};
+
+	struct TickFilter {
+		ComponentID id;
+		bool added;
+	};
+
+	using TickFilterVector = std::vector<TickFilter>;
+
 }
\ No newline at end of file
@@ -0,0 +1,181 @@
+#pragma once
+
+#include <vector>
+#include <span>
+#include <cstring>
+#include <cstdint>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+
+#include "snapshot.h"
+
+namespace Byte {
+
+	inline constexpr uint64_t DELTA_MAGIC{ 0x31544C4445545942ull };
+
+	// Literal runs end at the first stretch of this many zero bytes; shorter gaps are cheaper inline.
+	inline constexpr size_t DELTA_MIN_ZERO_RUN{ 3 };
+
+	inline size_t zeroRun(std::span<const std::byte> bytes, size_t first) {
+		size_t out{ first };
+
+		while (out + sizeof(uint64_t) <= bytes.size()) {
+			uint64_t word;
+			std::memcpy(&word, bytes.data() + out, sizeof(word));
+			if (word) {
+				break;
+			}
+			out += sizeof(word);
+		}
+
+		while (out < bytes.size() && bytes[out] == std::byte{}) {
+			++out;
+		}
+
+		return out - first;
+	}
+
+	// Writes bytes as alternating (zero run, literal run) pairs, which is what an XOR stream of mostly unchanged rows compresses to.
+	inline void encodeRuns(std::span<const std::byte> bytes, SnapshotWriter& writer) {
+		writer.varint(bytes.size());
+
+		for (size_t _index{}; _index < bytes.size();) {
+			size_t zeros{ zeroRun(bytes, _index) };
+			size_t first{ _index + zeros };
+			size_t last{ first };
+
+			while (last < bytes.size()) {
+				size_t gap{ zeroRun(bytes, last) };
+				if (gap >= DELTA_MIN_ZERO_RUN || last + gap == bytes.size()) {
+					break;
+				}
+				last += gap ? gap : 1;
+			}
+
+			writer.varint(zeros);
+			writer.varint(last - first);
+			writer.write(bytes.data() + first, last - first);
+			_index = last;
+		}
+	}
+
+	inline void decodeRuns(SnapshotReader& reader, std::vector<std::byte>& out) {
+		size_t size{ static_cast<size_t>(reader.varint()) };
+		out.assign(size, std::byte{});
+
+		for (size_t _index{}; _index < size;) {
+			size_t zeros{ static_cast<size_t>(reader.varint()) };
+			size_t literals{ static_cast<size_t>(reader.varint()) };
+
+			if (zeros > size - _index || literals > size - _index - zeros) {
+				throw std::runtime_error("World delta run overflows its stream");
+			}
+
+			_index += zeros;
+			std::span<const std::byte> bytes{ reader.bytes(literals) };
+			std::copy(bytes.begin(), bytes.end(), out.begin() + _index);
+			_index += literals;
+		}
+	}
+
+	template<typename Component>
+	const Component& defaultComponent() {
+		if constexpr (std::is_default_constructible_v<Component>) {
+			static const Component out{};
+			return out;
+		}
+		else {
+			throw std::logic_error("Component needs a default constructor to be replicated");
+		}
+	}
+
+	// Appends value XOR base (a default-constructed component when base is null) and reports whether anything differs.
+	template<typename Component>
+	bool diffComponent(const Component& value, const Component* base, std::vector<std::byte>& out) {
+		if constexpr (std::is_trivially_copyable_v<Component>) {
+			const std::byte* left{ reinterpret_cast<const std::byte*>(&value) };
+			const std::byte* right{ reinterpret_cast<const std::byte*>(base ? base : &defaultComponent<Component>()) };
+
+			size_t first{ out.size() };
+			out.resize(first + sizeof(Component));
+
+			std::byte changed{};
+			for (size_t _index{}; _index < sizeof(Component); ++_index) {
+				out[first + _index] = left[_index] ^ right[_index];
+				changed |= out[first + _index];
+			}
+			return changed != std::byte{};
+		}
+		else if constexpr (SERIALIZABLE<Component>) {
+			std::vector<std::byte> current;
+			std::vector<std::byte> previous;
+			{
+				SnapshotWriter writer{ current };
+				Serializer<Component>::save(writer, value);
+			}
+			{
+				SnapshotWriter writer{ previous };
+				Serializer<Component>::save(writer, base ? *base : defaultComponent<Component>());
+			}
+
+			SnapshotWriter writer{ out };
+			writer.varint(current.size() ^ previous.size());
+
+			for (size_t _index{}; _index < std::min(current.size(), previous.size()); ++_index) {
+				current[_index] ^= previous[_index];
+			}
+			writer.write(current.data(), current.size());
+
+			return current.size() != previous.size() || zeroRun(current, 0) != current.size();
+		}
+		else {
+			throw std::logic_error("Component needs a Serializer specialization to be replicated");
+		}
+	}
+
+	// Reverses diffComponent in place and reports whether the value changed.
+	template<typename Component>
+	bool patchComponent(Component& value, SnapshotReader& reader) {
+		if constexpr (std::is_trivially_copyable_v<Component>) {
+			std::span<const std::byte> delta{ reader.bytes(sizeof(Component)) };
+			if (zeroRun(delta, 0) == delta.size()) {
+				return false;
+			}
+
+			std::byte bytes[sizeof(Component)];
+			std::memcpy(bytes, &value, sizeof(Component));
+			for (size_t _index{}; _index < sizeof(Component); ++_index) {
+				bytes[_index] ^= delta[_index];
+			}
+			std::memcpy(&value, bytes, sizeof(Component));
+			return true;
+		}
+		else if constexpr (SERIALIZABLE<Component>) {
+			std::vector<std::byte> previous;
+			{
+				SnapshotWriter writer{ previous };
+				Serializer<Component>::save(writer, value);
+			}
+
+			size_t length{ static_cast<size_t>(reader.varint() ^ previous.size()) };
+			std::span<const std::byte> delta{ reader.bytes(length) };
+			if (length == previous.size() && zeroRun(delta, 0) == length) {
+				return false;
+			}
+
+			std::vector<std::byte> current(delta.begin(), delta.end());
+			for (size_t _index{}; _index < std::min(current.size(), previous.size()); ++_index) {
+				current[_index] ^= previous[_index];
+			}
+
+			SnapshotReader source{ current };
+			value = Serializer<Component>::load(source);
+			return true;
+		}
+		else {
+			throw std::logic_error("Component needs a Serializer specialization to be replicated");
+		}
+	}
+
+}
@@ -3,30 +3,36 @@
 #include <cstdint>
 #include <vector>
 #include <random>
+#include <memory_resource>
 
 #include "world.h"
 #include "utility.h"
+#include "chunk_vector.h"
+#include "aligned_allocator.h"
+#include "entity_table.h"
+#include "scheduler.h"
+#include "memory.h"
 
 namespace Byte {
 
-    template<typename Type>
-    class shrink_vector : public std::vector<Type> {
+    template<typename Type, typename Allocator = std::allocator<Type>>
+    class shrink_vector : public std::vector<Type, Allocator> {
     public:
-        using std::vector<Type>::vector;
+        using std::vector<Type, Allocator>::vector;
 
         void pop_back() {
-            std::vector<Type>::pop_back();
+            std::vector<Type, Allocator>::pop_back();
             check_shrink();
         }
 
-        typename std::vector<Type>::iterator erase(typename std::vector<Type>::iterator pos) {
-            auto it{ std::vector<Type>::erase(pos) };
+        typename std::vector<Type, Allocator>::iterator erase(typename std::vector<Type, Allocator>::iterator pos) {
+            auto it{ std::vector<Type, Allocator>::erase(pos) };
             check_shrink();
             return it;
         }
 
         void resize(size_t new_size) {
-            std::vector<Type>::resize(new_size);
+            std::vector<Type, Allocator>::resize(new_size);
             check_shrink();
         }
 
@@ -38,6 +44,12 @@ namespace Byte {
         }
     };
 
+    template<typename Type>
+    using aligned_shrink_vector = shrink_vector<Type, aligned_allocator<Type>>;
+
+    template<typename Type>
+    using pmr_shrink_vector = shrink_vector<Type, std::pmr::polymorphic_allocator<Type>>;
+
     struct EntityID {
         uint64_t id{};
 
@@ -69,8 +81,47 @@ namespace Byte {
         }
     };
 
+    struct DenseEntityID {
+        using index_type = uint32_t;
+        using generation_type = uint32_t;
+
+        index_type index{};
+        generation_type generation{};
+
+        explicit operator uint64_t() const {
+            return (static_cast<uint64_t>(generation) << 32) | index;
+        }
+
+        explicit operator bool() const {
+            return generation != 0;
+        }
+
+        bool operator==(const DenseEntityID& entity) const {
+            return entity.index == index && entity.generation == generation;
+        }
+
+        bool operator!=(const DenseEntityID& entity) const {
+            return !(*this == entity);
+        }
+    };
+
+    template<typename EntityID>
+    struct DenseEntityIDGenerator {
+        template<typename Value>
+        using Table = entity_table<EntityID, Value, std::pmr::polymorphic_allocator<std::pair<EntityID, Value>>>;
+    };
+
     using World = _World<EntityID, EntityIDGenerator, shrink_vector, 1024>;
 
+    using DenseWorld = _World<DenseEntityID, DenseEntityIDGenerator, shrink_vector, 1024>;
+
+    using ChunkedWorld = _World<EntityID, EntityIDGenerator, chunk_vector, 1024>;
+
+    using AlignedWorld = _World<EntityID, EntityIDGenerator, aligned_shrink_vector, 1024>;
+
+    // Columns, entity map and tables draw from the memory_resource passed to the constructor.
+    using PmrWorld = _World<EntityID, EntityIDGenerator, pmr_shrink_vector, 1024>;
+
 }
 
 namespace std {
@@ -82,4 +133,11 @@ namespace std {
         }
     };
 
+    template<>
+    struct hash<Byte::DenseEntityID> {
+        size_t operator()(const Byte::DenseEntityID& entity) const noexcept {
+            return std::hash<uint64_t>{}(static_cast<uint64_t>(entity));
+        }
+    };
+
 }
\ No newline at end of file
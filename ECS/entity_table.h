@@ -0,0 +1,335 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <utility>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+#include <stdexcept>
+#include <span>
+#include <algorithm>
+#include <atomic>
+
+#include "prefetch.h"
+
+namespace Byte {
+
+	template<typename _Key, typename _Value, typename _Allocator = std::allocator<std::pair<_Key, _Value>>>
+	class entity_table {
+	public:
+		using key_type = _Key;
+		using value_type = _Value;
+		using index_type = typename key_type::index_type;
+		using generation_type = typename key_type::generation_type;
+		using allocator_type = _Allocator;
+
+		using map_node = std::pair<_Key, _Value>;
+
+	private:
+		template<typename Type>
+		using rebind_alloc = typename std::allocator_traits<_Allocator>::template rebind_alloc<Type>;
+
+		using node_vector = std::vector<map_node, rebind_alloc<map_node>>;
+		using generation_vector = std::vector<generation_type, rebind_alloc<generation_type>>;
+		using index_vector = std::vector<index_type, rebind_alloc<index_type>>;
+		using flag_vector = std::vector<bool, rebind_alloc<bool>>;
+
+		inline static constexpr size_t prefetch_distance{ 8 };
+
+		node_vector _nodes;
+		generation_vector _generations;
+		index_vector _free;
+		// Whether each slot is free to hand out. emplace() can fill a slot that is still on _free; that entry is
+		// skipped when popped rather than searched for, so bulk loads stay linear.
+		flag_vector _listed;
+		size_t _size{};
+		// One past the highest index handed out, including reserve_key() indices whose slots do not exist yet.
+		alignas(std::atomic_ref<size_t>::required_alignment) size_t _end{};
+
+		template<typename _Node, typename _Iterator>
+		class live_iterator {
+		private:
+			_Iterator _current;
+			_Iterator _last;
+
+		public:
+			using iterator_category = std::forward_iterator_tag;
+			using value_type = std::remove_const_t<_Node>;
+			using difference_type = std::ptrdiff_t;
+			using pointer = _Node*;
+			using reference = _Node&;
+
+			live_iterator() = default;
+
+			live_iterator(_Iterator current, _Iterator last)
+				: _current{ current }, _last{ last } {
+				skip();
+			}
+
+			reference operator*() const {
+				return *_current;
+			}
+
+			pointer operator->() const {
+				return &*_current;
+			}
+
+			live_iterator& operator++() {
+				++_current;
+				skip();
+				return *this;
+			}
+
+			live_iterator operator++(int) {
+				live_iterator out{ *this };
+				++*this;
+				return out;
+			}
+
+			bool operator==(const live_iterator& other) const {
+				return _current == other._current;
+			}
+
+			bool operator!=(const live_iterator& other) const {
+				return _current != other._current;
+			}
+
+		private:
+			void skip() {
+				while (_current != _last && !_current->first) {
+					++_current;
+				}
+			}
+		};
+
+	public:
+		using iterator = live_iterator<map_node, typename node_vector::iterator>;
+		using const_iterator = live_iterator<const map_node, typename node_vector::const_iterator>;
+
+		entity_table()
+			: entity_table{ allocator_type{} } {
+		}
+
+		explicit entity_table(const allocator_type& allocator)
+			: _nodes{ allocator }, _generations{ allocator }, _free{ allocator }, _listed{ allocator } {
+		}
+
+		allocator_type get_allocator() const {
+			return _nodes.get_allocator();
+		}
+
+		key_type generate() {
+			index_type _index;
+			if (popFree(_index)) {
+				return key_type{ _index, _generations[_index] };
+			}
+
+			size_t fresh{ std::atomic_ref<size_t>{ _end }.fetch_add(1, std::memory_order_relaxed) };
+			grow(fresh + 1);
+			return key_type{ static_cast<index_type>(fresh), 1 };
+		}
+
+		void generate(std::span<key_type> out) {
+			size_t reused{};
+			for (index_type _index; reused < out.size() && popFree(_index); ++reused) {
+				out[reused] = key_type{ _index, _generations[_index] };
+			}
+
+			size_t first{ std::atomic_ref<size_t>{ _end }.fetch_add(out.size() - reused, std::memory_order_relaxed) };
+			grow(first + out.size() - reused);
+			for (size_t idx{ reused }; idx < out.size(); ++idx) {
+				out[idx] = key_type{ static_cast<index_type>(first + idx - reused), 1 };
+			}
+		}
+
+		// Safe to call from several threads while the table is read: only bumps the high-water mark. The slot is
+		// created when the key is emplaced, or handed back with release_key() if it never is.
+		key_type reserve_key() {
+			return key_type{ static_cast<index_type>(std::atomic_ref<size_t>{ _end }.fetch_add(1, std::memory_order_relaxed)), 1 };
+		}
+
+		void release_key(const key_type& key) {
+			grow(static_cast<size_t>(key.index) + 1);
+			if (_nodes[key.index].first || _listed[key.index]) {
+				return;
+			}
+
+			// Retire the reserved key, so it cannot alias whichever entity gets the slot next.
+			generation_type& generation{ _generations[key.index] };
+			if (++generation == 0) {
+				++generation;
+			}
+			_free.push_back(key.index);
+			_listed[key.index] = true;
+		}
+
+		value_type& at(const key_type& key) {
+			if (!contains(key)) {
+				throw std::out_of_range("Key not found");
+			}
+			return _nodes[key.index].second;
+		}
+
+		const value_type& at(const key_type& key) const {
+			if (!contains(key)) {
+				throw std::out_of_range("Key not found");
+			}
+			return _nodes[key.index].second;
+		}
+
+		value_type& operator[](const key_type& key) {
+			return _nodes[key.index].second;
+		}
+
+		const value_type& operator[](const key_type& key) const {
+			return _nodes[key.index].second;
+		}
+
+		bool contains(const key_type& key) const {
+			return key.index < _nodes.size() && _nodes[key.index].first == key;
+		}
+
+		iterator find(const key_type& key) {
+			if (contains(key)) {
+				return iterator{ _nodes.begin() + key.index, _nodes.end() };
+			}
+			return end();
+		}
+
+		const_iterator find(const key_type& key) const {
+			if (contains(key)) {
+				return const_iterator{ _nodes.begin() + key.index, _nodes.end() };
+			}
+			return end();
+		}
+
+		void find_batch(std::span<const key_type> keys, std::span<value_type*> out) {
+			for (size_t idx{}; idx < keys.size(); ++idx) {
+				if (idx + prefetch_distance < keys.size() && keys[idx + prefetch_distance].index < _nodes.size()) {
+					prefetch(&_nodes[keys[idx + prefetch_distance].index]);
+				}
+				out[idx] = contains(keys[idx]) ? &_nodes[keys[idx].index].second : nullptr;
+			}
+		}
+
+		template<typename... _Args>
+		void emplace(const key_type& key, _Args&&... args) {
+			// Slots skipped past the high-water mark were never handed out, so they are free; those below it are reserved.
+			std::atomic_ref<size_t> claimed{ _end };
+			size_t last{ claimed.load(std::memory_order_relaxed) };
+			while (last <= key.index && !claimed.compare_exchange_weak(last, key.index + size_t{ 1 }, std::memory_order_relaxed)) {
+			}
+
+			if (last <= key.index) {
+				grow(last);
+				for (size_t _index{ _nodes.size() }; _index < key.index; ++_index) {
+					_free.push_back(static_cast<index_type>(_index));
+				}
+				_nodes.resize(key.index);
+				_generations.resize(key.index, 1);
+				_listed.resize(key.index, true);
+			}
+			grow(static_cast<size_t>(key.index) + 1);
+			_listed[key.index] = false;
+
+			if (!_nodes[key.index].first) {
+				++_size;
+			}
+
+			_generations[key.index] = key.generation;
+			_nodes[key.index] = map_node{ key, value_type(std::forward<_Args>(args)...) };
+		}
+
+		void erase(const key_type& key) {
+			if (!contains(key)) {
+				return;
+			}
+
+			generation_type& generation{ _generations[key.index] };
+			if (++generation == 0) {
+				++generation;
+			}
+
+			_nodes[key.index] = map_node{};
+			_free.push_back(key.index);
+			_listed[key.index] = true;
+			--_size;
+		}
+
+		size_t size() const {
+			return _size;
+		}
+
+		bool empty() const {
+			return _size == 0;
+		}
+
+		size_t capacity() const {
+			return _nodes.capacity();
+		}
+
+		void reserve(size_t new_capacity) {
+			_nodes.reserve(new_capacity);
+			_generations.reserve(new_capacity);
+			_listed.reserve(new_capacity);
+		}
+
+		iterator begin() {
+			return iterator{ _nodes.begin(), _nodes.end() };
+		}
+
+		iterator end() {
+			return iterator{ _nodes.end(), _nodes.end() };
+		}
+
+		const_iterator begin() const {
+			return const_iterator{ _nodes.begin(), _nodes.end() };
+		}
+
+		const_iterator end() const {
+			return const_iterator{ _nodes.end(), _nodes.end() };
+		}
+
+		void clear() {
+			_free.clear();
+
+			// Slots reserved with reserve_key() and not yet emplaced stay reserved.
+			for (size_t _index{ _nodes.size() }; _index-- > 0;) {
+				if (!_nodes[_index].first && !_listed[_index]) {
+					continue;
+				}
+				if (_nodes[_index].first && ++_generations[_index] == 0) {
+					++_generations[_index];
+				}
+				_nodes[_index] = map_node{};
+				_free.push_back(static_cast<index_type>(_index));
+				_listed[_index] = true;
+			}
+
+			_size = 0;
+		}
+
+	private:
+		void grow(size_t count) {
+			if (_nodes.size() < count) {
+				_nodes.resize(count);
+				_generations.resize(count, 1);
+				_listed.resize(count, false);
+			}
+		}
+
+		bool popFree(index_type& out) {
+			while (!_free.empty()) {
+				out = _free.back();
+				_free.pop_back();
+				if (_listed[out]) {
+					_listed[out] = false;
+					return true;
+				}
+			}
+			return false;
+		}
+	};
+
+}
@@ -1,9 +1,22 @@
 #pragma once
 
 #include <vector>
+#include <memory>
 #include <utility>
 #include <limits>
 #include <stdexcept>
+#include <functional>
+#include <bit>
+#include <cstdint>
+#include <span>
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define BYTE_HASH_MAP_SSE2
+#endif
+
+#include "prefetch.h"
 
 namespace Byte {
 
@@ -27,12 +40,15 @@ namespace Byte {
 		}
 	};
 
+	struct group_probe {};
+
 	template<
 		typename _Key,
 		typename _Value,
 		typename _Hasher = std::hash<_Key>,
 		typename _Keyequal = std::equal_to<_Key>,
-		typename _Probe = double_hash_probe>
+		typename _Probe = double_hash_probe,
+		typename _Allocator = std::allocator<std::pair<_Key, _Value>>>
 	class hash_map {
 	public:
 		using key_type = _Key;
@@ -41,6 +57,7 @@ namespace Byte {
 		using hasher = _Hasher;
 		using key_equal = _Keyequal;
 		using probe = _Probe;
+		using allocator_type = _Allocator;
 
 		using map_node = std::pair<_Key, _Value>;
 
@@ -48,8 +65,12 @@ namespace Byte {
 		inline static constexpr size_t empty_index{ std::numeric_limits<size_t>::max() };
 		inline static constexpr size_t deleted_index{ empty_index - 1 };
 		inline static constexpr size_t rehash_factor{ 3 };
+		inline static constexpr size_t batch_size{ 16 };
+
+		template<typename Type>
+		using rebind_alloc = typename std::allocator_traits<_Allocator>::template rebind_alloc<Type>;
 
-		using node_vector = std::vector<map_node>;
+		using node_vector = std::vector<map_node, rebind_alloc<map_node>>;
 		node_vector _nodes;
 
 		struct index_node {
@@ -57,7 +78,7 @@ namespace Byte {
 			size_t hash_value{};
 		};
 
-		using index_vector = std::vector<index_node>;
+		using index_vector = std::vector<index_node, rebind_alloc<index_node>>;
 		index_vector _indices;
 
 		hasher _hash;
@@ -69,10 +90,19 @@ namespace Byte {
 		using const_iterator = typename node_vector::const_iterator;
 
 	public:
-		hash_map() {
+		hash_map()
+			: hash_map{ allocator_type{} } {
+		}
+
+		explicit hash_map(const allocator_type& allocator)
+			: _nodes{ allocator }, _indices{ allocator } {
 			_indices.resize(rehash_factor);
 		}
 
+		allocator_type get_allocator() const {
+			return _nodes.get_allocator();
+		}
+
 		value_type& at(const key_type& key) {
 			size_t _index{ find_index(key) };
 
@@ -138,6 +168,24 @@ namespace Byte {
 			return end();
 		}
 
+		void find_batch(std::span<const key_type> keys, std::span<value_type*> out) {
+			size_t hashes[batch_size];
+
+			for (size_t first{}; first < keys.size(); first += batch_size) {
+				size_t count{ std::min(batch_size, keys.size() - first) };
+
+				for (size_t idx{}; idx < count; ++idx) {
+					hashes[idx] = _hash(keys[first + idx]);
+					prefetch(&_indices[hashes[idx] % _indices.size()]);
+				}
+
+				for (size_t idx{}; idx < count; ++idx) {
+					size_t _index{ find_index(keys[first + idx], hashes[idx]) };
+					out[first + idx] = _index == empty_index ? nullptr : &_nodes[_indices[_index]._index].second;
+				}
+			}
+		}
+
 		void erase(const key_type& key) {
 			size_t node_index{ find_index(key) };
 
@@ -206,29 +254,38 @@ namespace Byte {
 			return _indices[_index]._index < deleted_index;
 		}
 
+		size_t probe_index(size_t primary_hash, size_t attempt) const {
+			if (attempt < _indices.size()) {
+				return _probe(primary_hash, attempt) % _indices.size();
+			}
+			return (primary_hash + attempt) % _indices.size();
+		}
+
 		size_t find_free_index(size_t primary_hash) const {
 			size_t hash_value{ primary_hash % _indices.size() };
 
 			for (size_t attempt{ 1 }; _indices[hash_value]._index != empty_index; ++attempt) {
-				hash_value = _probe(primary_hash, attempt) % _indices.size();
+				hash_value = probe_index(primary_hash, attempt);
 			}
 
 			return hash_value;
 		}
 
 		size_t find_index(const key_type& key) const {
-			size_t primary_hash{ _hash(key) };
-			size_t hash_value{ primary_hash % _indices.size() };
+			return find_index(key, _hash(key));
+		}
 
-			if (full_index(hash_value) && _equal(_nodes[_indices[hash_value]._index].first, key)) {
-				return hash_value;
-			}
+		size_t find_index(const key_type& key, size_t primary_hash) const {
+			size_t hash_value{ primary_hash % _indices.size() };
 
-			for (size_t attempt{ 1 }; attempt < _indices.size(); ++attempt) {
-				hash_value = _probe(primary_hash, attempt) % _indices.size();
+			for (size_t attempt{ 1 }; attempt < 2 * _indices.size(); ++attempt) {
+				if (_indices[hash_value]._index == empty_index) {
+					return empty_index;
+				}
 				if (full_index(hash_value) && _equal(_nodes[_indices[hash_value]._index].first, key)) {
 					return hash_value;
 				}
+				hash_value = probe_index(primary_hash, attempt);
 			}
 
 			return empty_index;
@@ -248,4 +305,363 @@ namespace Byte {
 		}
 	};
 
+
+	template<
+		typename _Key,
+		typename _Value,
+		typename _Hasher,
+		typename _Keyequal,
+		typename _Allocator>
+	class hash_map<_Key, _Value, _Hasher, _Keyequal, group_probe, _Allocator> {
+	public:
+		using key_type = _Key;
+		using value_type = _Value;
+
+		using hasher = _Hasher;
+		using key_equal = _Keyequal;
+		using probe = group_probe;
+		using allocator_type = _Allocator;
+
+		using map_node = std::pair<_Key, _Value>;
+
+	private:
+		using control_type = int8_t;
+		using mask_type = uint32_t;
+
+		inline static constexpr control_type empty_control{ -128 };
+		inline static constexpr control_type deleted_control{ -2 };
+		inline static constexpr size_t group_size{ 16 };
+		inline static constexpr size_t min_capacity{ group_size };
+		inline static constexpr size_t npos{ std::numeric_limits<size_t>::max() };
+		inline static constexpr size_t batch_size{ 16 };
+
+		template<typename Type>
+		using rebind_alloc = typename std::allocator_traits<_Allocator>::template rebind_alloc<Type>;
+
+		using node_vector = std::vector<map_node, rebind_alloc<map_node>>;
+		using control_vector = std::vector<control_type, rebind_alloc<control_type>>;
+		using slot_vector = std::vector<size_t, rebind_alloc<size_t>>;
+
+		node_vector _nodes;
+		control_vector _control;
+		slot_vector _slots;
+		size_t _growth_left{};
+
+		hasher _hash;
+		key_equal _equal;
+
+	public:
+		using iterator = typename node_vector::iterator;
+		using const_iterator = typename node_vector::const_iterator;
+
+	public:
+		hash_map()
+			: hash_map{ allocator_type{} } {
+		}
+
+		explicit hash_map(const allocator_type& allocator)
+			: _nodes{ allocator }, _control{ allocator }, _slots{ allocator } {
+			rehash(min_capacity);
+		}
+
+		allocator_type get_allocator() const {
+			return _nodes.get_allocator();
+		}
+
+		value_type& at(const key_type& key) {
+			size_t slot{ find_slot(key) };
+
+			if (slot == npos) {
+				throw std::out_of_range("Key not found");
+			}
+
+			return _nodes[_slots[slot]].second;
+		}
+
+		const value_type& at(const key_type& key) const {
+			size_t slot{ find_slot(key) };
+
+			if (slot == npos) {
+				throw std::out_of_range("Key not found");
+			}
+
+			return _nodes[_slots[slot]].second;
+		}
+
+		template<typename... _Args >
+		void emplace(_Args... args) {
+			if (_growth_left == 0) {
+				rehash(size() <= slot_count() * 25 / 32 ? slot_count() : slot_count() * 2);
+			}
+
+			_nodes.emplace_back(std::forward<_Args>(args)...);
+			insert_slot(mix(_hash(_nodes.back().first)), _nodes.size() - 1);
+		}
+
+		const value_type& operator[](const key_type& key) const {
+			return at(key);
+		}
+
+		value_type& operator[](const key_type& key) {
+			size_t slot{ find_slot(key) };
+
+			if (slot != npos) {
+				return _nodes[_slots[slot]].second;
+			}
+
+			emplace(key, value_type{});
+
+			return _nodes.back().second;
+		}
+
+		iterator find(const key_type& key) {
+			size_t slot{ find_slot(key) };
+			if (slot != npos) {
+				return iterator{ _nodes.begin() + _slots[slot] };
+			}
+			return end();
+		}
+
+		const_iterator find(const key_type& key) const {
+			size_t slot{ find_slot(key) };
+			if (slot != npos) {
+				return const_iterator{ _nodes.begin() + _slots[slot] };
+			}
+			return end();
+		}
+
+		void find_batch(std::span<const key_type> keys, std::span<value_type*> out) {
+			size_t hashes[batch_size];
+
+			for (size_t first{}; first < keys.size(); first += batch_size) {
+				size_t count{ std::min(batch_size, keys.size() - first) };
+
+				for (size_t idx{}; idx < count; ++idx) {
+					hashes[idx] = mix(_hash(keys[first + idx]));
+					prefetch(&_control[(hashes[idx] >> 7) & slot_mask()]);
+				}
+
+				for (size_t idx{}; idx < count; ++idx) {
+					size_t slot{ (hashes[idx] >> 7) & slot_mask() };
+					mask_type bits{ match(slot, fingerprint(hashes[idx])) };
+					if (bits) {
+						prefetch(&_nodes[_slots[(slot + std::countr_zero(bits)) & slot_mask()]]);
+					}
+				}
+
+				for (size_t idx{}; idx < count; ++idx) {
+					size_t slot{ find_slot(keys[first + idx], hashes[idx]) };
+					out[first + idx] = slot == npos ? nullptr : &_nodes[_slots[slot]].second;
+				}
+			}
+		}
+
+		void erase(const key_type& key) {
+			size_t slot{ find_slot(key) };
+
+			if (slot == npos) {
+				return;
+			}
+
+			size_t node_pos{ _slots[slot] };
+			if (node_pos != _nodes.size() - 1) {
+				_slots[find_slot(_nodes.back().first)] = node_pos;
+				std::swap(_nodes[node_pos], _nodes.back());
+			}
+			_nodes.pop_back();
+
+			erase_slot(slot);
+
+			if (need_shrink()) {
+				rehash(capacity_for(size() * 2));
+				_nodes.shrink_to_fit();
+			}
+		}
+
+		size_t size() const {
+			return _nodes.size();
+		}
+
+		size_t capacity() const {
+			return _nodes.capacity();
+		}
+
+		void reserve(size_t new_capacity) {
+			_nodes.reserve(new_capacity);
+			if (new_capacity > max_load(slot_count())) {
+				rehash(capacity_for(new_capacity));
+			}
+		}
+
+		iterator begin() {
+			return _nodes.begin();
+		}
+
+		iterator end() {
+			return _nodes.end();
+		}
+
+		const_iterator begin() const {
+			return _nodes.begin();
+		}
+
+		const_iterator end() const {
+			return _nodes.end();
+		}
+
+		void clear() {
+			_nodes.clear();
+			rehash(min_capacity);
+		}
+
+	private:
+		static size_t mix(size_t hash_value) {
+			uint64_t out{ static_cast<uint64_t>(hash_value) * 0x9E3779B97F4A7C15ull };
+			return static_cast<size_t>(out ^ (out >> 32));
+		}
+
+		static control_type fingerprint(size_t hash_value) {
+			return static_cast<control_type>(hash_value & 0x7F);
+		}
+
+		static size_t max_load(size_t slot_count) {
+			return slot_count - slot_count / 8;
+		}
+
+		static size_t capacity_for(size_t count) {
+			size_t out{ min_capacity };
+			while (max_load(out) < count) {
+				out *= 2;
+			}
+			return out;
+		}
+
+		size_t slot_count() const {
+			return _slots.size();
+		}
+
+		size_t slot_mask() const {
+			return _slots.size() - 1;
+		}
+
+		bool need_shrink() const {
+			return slot_count() > min_capacity && size() * 4 < max_load(slot_count());
+		}
+
+#ifdef BYTE_HASH_MAP_SSE2
+		__m128i load_group(size_t slot) const {
+			return _mm_loadu_si128(reinterpret_cast<const __m128i*>(_control.data() + slot));
+		}
+
+		mask_type match(size_t slot, control_type control) const {
+			return static_cast<mask_type>(_mm_movemask_epi8(_mm_cmpeq_epi8(load_group(slot), _mm_set1_epi8(control))));
+		}
+
+		mask_type match_empty(size_t slot) const {
+			return match(slot, empty_control);
+		}
+
+		mask_type match_free(size_t slot) const {
+			return static_cast<mask_type>(_mm_movemask_epi8(load_group(slot)));
+		}
+#else
+		mask_type match(size_t slot, control_type control) const {
+			mask_type out{};
+			for (size_t idx{}; idx < group_size; ++idx) {
+				out |= static_cast<mask_type>(_control[slot + idx] == control) << idx;
+			}
+			return out;
+		}
+
+		mask_type match_empty(size_t slot) const {
+			return match(slot, empty_control);
+		}
+
+		mask_type match_free(size_t slot) const {
+			mask_type out{};
+			for (size_t idx{}; idx < group_size; ++idx) {
+				out |= static_cast<mask_type>(_control[slot + idx] < 0) << idx;
+			}
+			return out;
+		}
+#endif
+
+		void set_control(size_t slot, control_type control) {
+			_control[slot] = control;
+			if (slot < group_size) {
+				_control[slot_count() + slot] = control;
+			}
+		}
+
+		size_t find_slot(const key_type& key) const {
+			return find_slot(key, mix(_hash(key)));
+		}
+
+		size_t find_slot(const key_type& key, size_t hash_value) const {
+			control_type control{ fingerprint(hash_value) };
+			size_t slot{ (hash_value >> 7) & slot_mask() };
+
+			for (size_t step{ group_size }; ; step += group_size) {
+				for (mask_type bits{ match(slot, control) }; bits; bits &= bits - 1) {
+					size_t candidate{ (slot + std::countr_zero(bits)) & slot_mask() };
+					if (_equal(_nodes[_slots[candidate]].first, key)) {
+						return candidate;
+					}
+				}
+
+				if (match_empty(slot) || step > slot_count()) {
+					return npos;
+				}
+
+				slot = (slot + step) & slot_mask();
+			}
+		}
+
+		size_t find_free_slot(size_t hash_value) const {
+			size_t slot{ (hash_value >> 7) & slot_mask() };
+
+			for (size_t step{ group_size }; ; step += group_size) {
+				mask_type bits{ match_free(slot) };
+				if (bits) {
+					return (slot + std::countr_zero(bits)) & slot_mask();
+				}
+				slot = (slot + step) & slot_mask();
+			}
+		}
+
+		void insert_slot(size_t hash_value, size_t node_index) {
+			size_t slot{ find_free_slot(hash_value) };
+
+			_growth_left -= _control[slot] == empty_control;
+			set_control(slot, fingerprint(hash_value));
+			_slots[slot] = node_index;
+		}
+
+		void erase_slot(size_t slot) {
+			mask_type empty_after{ match_empty(slot) };
+			mask_type empty_before{ match_empty((slot - group_size) & slot_mask()) };
+
+			bool was_never_full{
+				empty_before && empty_after &&
+				static_cast<size_t>(std::countr_zero(empty_after) + std::countl_zero(empty_before << 16)) < group_size };
+
+			set_control(slot, was_never_full ? empty_control : deleted_control);
+			_growth_left += was_never_full;
+		}
+
+		void rehash(size_t new_capacity) {
+			_control.assign(new_capacity + group_size, empty_control);
+			_slots.assign(new_capacity, npos);
+			_growth_left = max_load(new_capacity);
+
+			for (size_t idx{}; idx < _nodes.size(); ++idx) {
+				size_t hash_value{ mix(_hash(_nodes[idx].first)) };
+				size_t slot{ find_free_slot(hash_value) };
+				set_control(slot, fingerprint(hash_value));
+				_slots[slot] = idx;
+				--_growth_left;
+			}
+		}
+	};
+
 }
\ No newline at end of file
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <string>
+#include <cstddef>
+#include <utility>
+#include <stdexcept>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace Byte {
+
+	class mapped_file {
+	private:
+		const std::byte* _data{ nullptr };
+		size_t _size{};
+#if defined(_WIN32)
+		HANDLE _file{ INVALID_HANDLE_VALUE };
+		HANDLE _mapping{ nullptr };
+#endif
+
+	public:
+		mapped_file() = default;
+
+		explicit mapped_file(const std::string& path) {
+#if defined(_WIN32)
+			_file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+			if (_file == INVALID_HANDLE_VALUE) {
+				throw std::runtime_error("Cannot open " + path);
+			}
+
+			LARGE_INTEGER size;
+			GetFileSizeEx(_file, &size);
+			_size = static_cast<size_t>(size.QuadPart);
+
+			if (_size) {
+				_mapping = CreateFileMappingA(_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+				void* view{ _mapping ? MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0) : nullptr };
+				if (!view) {
+					close();
+					throw std::runtime_error("Cannot map " + path);
+				}
+				_data = static_cast<const std::byte*>(view);
+			}
+#else
+			int file{ ::open(path.c_str(), O_RDONLY) };
+			if (file < 0) {
+				throw std::runtime_error("Cannot open " + path);
+			}
+
+			struct stat status;
+			::fstat(file, &status);
+			_size = static_cast<size_t>(status.st_size);
+
+			if (_size) {
+				void* view{ ::mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, file, 0) };
+				if (view == MAP_FAILED) {
+					::close(file);
+					throw std::runtime_error("Cannot map " + path);
+				}
+				::madvise(view, _size, MADV_WILLNEED);
+				_data = static_cast<const std::byte*>(view);
+			}
+			::close(file);
+#endif
+		}
+
+		mapped_file(const mapped_file&) = delete;
+
+		mapped_file(mapped_file&& right) noexcept {
+			*this = std::move(right);
+		}
+
+		mapped_file& operator=(const mapped_file&) = delete;
+
+		mapped_file& operator=(mapped_file&& right) noexcept {
+			if (this != &right) {
+				close();
+				_data = std::exchange(right._data, nullptr);
+				_size = std::exchange(right._size, 0);
+#if defined(_WIN32)
+				_file = std::exchange(right._file, INVALID_HANDLE_VALUE);
+				_mapping = std::exchange(right._mapping, nullptr);
+#endif
+			}
+			return *this;
+		}
+
+		~mapped_file() {
+			close();
+		}
+
+		const std::byte* data() const {
+			return _data;
+		}
+
+		size_t size() const {
+			return _size;
+		}
+
+	private:
+		void close() {
+#if defined(_WIN32)
+			if (_data) {
+				UnmapViewOfFile(_data);
+			}
+			if (_mapping) {
+				CloseHandle(_mapping);
+			}
+			if (_file != INVALID_HANDLE_VALUE) {
+				CloseHandle(_file);
+			}
+			_mapping = nullptr;
+			_file = INVALID_HANDLE_VALUE;
+#else
+			if (_data) {
+				::munmap(const_cast<std::byte*>(_data), _size);
+			}
+#endif
+			_data = nullptr;
+			_size = 0;
+		}
+	};
+
+}
@@ -0,0 +1,220 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <atomic>
+#include <utility>
+#include <memory_resource>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+namespace Byte {
+
+	// Requests of at least threshold bytes (column buffers, entity tables) get their own huge-page mapping; smaller ones go to upstream.
+	class huge_page_resource : public std::pmr::memory_resource {
+	public:
+		inline static constexpr size_t page_size{ size_t{ 1 } << 21 };
+
+	private:
+		std::pmr::memory_resource* _upstream;
+		size_t _threshold;
+
+	public:
+		explicit huge_page_resource(
+			std::pmr::memory_resource* upstream = std::pmr::get_default_resource(),
+			size_t threshold = page_size / 2)
+			: _upstream{ upstream }, _threshold{ threshold } {
+		}
+
+		std::pmr::memory_resource* upstream() const {
+			return _upstream;
+		}
+
+	private:
+		void* do_allocate(size_t bytes, size_t alignment) override {
+			if (bytes < _threshold) {
+				return _upstream->allocate(bytes, alignment);
+			}
+			if (alignment > page_size) {
+				throw std::bad_alloc{};
+			}
+			return map(round(bytes));
+		}
+
+		void do_deallocate(void* pointer, size_t bytes, size_t alignment) override {
+			if (bytes < _threshold) {
+				_upstream->deallocate(pointer, bytes, alignment);
+				return;
+			}
+			unmap(pointer, round(bytes));
+		}
+
+		bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+			return this == &other;
+		}
+
+		static size_t round(size_t bytes) {
+			return (bytes + page_size - 1) & ~(page_size - 1);
+		}
+
+		static void* map(size_t size) {
+#if defined(_WIN32)
+			// Large pages need SeLockMemoryPrivilege; without it this quietly falls back to regular pages.
+			void* out{ nullptr };
+			size_t large{ GetLargePageMinimum() };
+			if (large && size % large == 0) {
+				out = VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+			}
+			if (!out) {
+				out = VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+			}
+			if (!out) {
+				throw std::bad_alloc{};
+			}
+			return out;
+#else
+#if defined(MAP_HUGETLB)
+			void* out{ mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0) };
+			if (out != MAP_FAILED) {
+				return out;
+			}
+#endif
+			// No reserved huge pages: map with slack, trim to a 2 MiB boundary and let transparent huge pages back it.
+			void* raw{ mmap(nullptr, size + page_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0) };
+			if (raw == MAP_FAILED) {
+				throw std::bad_alloc{};
+			}
+
+			std::byte* first{ static_cast<std::byte*>(raw) };
+			std::byte* aligned{ reinterpret_cast<std::byte*>((reinterpret_cast<uintptr_t>(first) + page_size - 1) & ~(page_size - 1)) };
+			if (aligned != first) {
+				munmap(first, aligned - first);
+			}
+			if (size_t tail{ page_size - static_cast<size_t>(aligned - first) }) {
+				munmap(aligned + size, tail);
+			}
+
+#if defined(MADV_HUGEPAGE)
+			madvise(aligned, size, MADV_HUGEPAGE);
+#endif
+			return aligned;
+#endif
+		}
+
+		static void unmap(void* pointer, size_t size) {
+#if defined(_WIN32)
+			VirtualFree(pointer, 0, MEM_RELEASE);
+#else
+			munmap(pointer, size);
+#endif
+		}
+	};
+
+	// Forwards to upstream and keeps counts, e.g. to check that a steady-state frame allocates nothing.
+	class counting_resource : public std::pmr::memory_resource {
+	private:
+		std::pmr::memory_resource* _upstream;
+		std::atomic<size_t> _allocations{};
+		std::atomic<size_t> _deallocations{};
+		std::atomic<size_t> _bytes{};
+		std::atomic<size_t> _peak{};
+
+	public:
+		explicit counting_resource(std::pmr::memory_resource* upstream = std::pmr::get_default_resource())
+			: _upstream{ upstream } {
+		}
+
+		size_t allocations() const {
+			return _allocations.load(std::memory_order_relaxed);
+		}
+
+		size_t deallocations() const {
+			return _deallocations.load(std::memory_order_relaxed);
+		}
+
+		size_t bytes() const {
+			return _bytes.load(std::memory_order_relaxed);
+		}
+
+		size_t peak() const {
+			return _peak.load(std::memory_order_relaxed);
+		}
+
+		void reset() {
+			_allocations.store(0, std::memory_order_relaxed);
+			_deallocations.store(0, std::memory_order_relaxed);
+			_peak.store(bytes(), std::memory_order_relaxed);
+		}
+
+	private:
+		void* do_allocate(size_t bytes, size_t alignment) override {
+			void* out{ _upstream->allocate(bytes, alignment) };
+
+			_allocations.fetch_add(1, std::memory_order_relaxed);
+			size_t live{ _bytes.fetch_add(bytes, std::memory_order_relaxed) + bytes };
+			size_t peak{ _peak.load(std::memory_order_relaxed) };
+			while (live > peak && !_peak.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+			}
+
+			return out;
+		}
+
+		void do_deallocate(void* pointer, size_t bytes, size_t alignment) override {
+			_upstream->deallocate(pointer, bytes, alignment);
+			_deallocations.fetch_add(1, std::memory_order_relaxed);
+			_bytes.fetch_sub(bytes, std::memory_order_relaxed);
+		}
+
+		bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+			return this == &other;
+		}
+	};
+
+	// A pool or monotonic resource whose large blocks come from huge pages; construct with the wrapped resource's arguments minus the upstream.
+	template<typename Resource>
+	class huge_page_backed : public std::pmr::memory_resource {
+	private:
+		huge_page_resource _pages;
+		Resource _resource;
+
+	public:
+		template<typename... Args>
+		explicit huge_page_backed(Args&&... args)
+			: _resource{ std::forward<Args>(args)..., &_pages } {
+		}
+
+		Resource& get() {
+			return _resource;
+		}
+
+	private:
+		void* do_allocate(size_t bytes, size_t alignment) override {
+			return _resource.allocate(bytes, alignment);
+		}
+
+		void do_deallocate(void* pointer, size_t bytes, size_t alignment) override {
+			_resource.deallocate(pointer, bytes, alignment);
+		}
+
+		bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+			return this == &other;
+		}
+	};
+
+	// One per world; like the world itself it is not thread-safe.
+	using huge_page_pool = huge_page_backed<std::pmr::unsynchronized_pool_resource>;
+
+	// Shared between worlds on different threads.
+	using synchronized_huge_page_pool = huge_page_backed<std::pmr::synchronized_pool_resource>;
+
+	// For short-lived worlds (per-frame forks, scratch spawns); get().release() frees everything at once.
+	using huge_page_monotonic = huge_page_backed<std::pmr::monotonic_buffer_resource>;
+
+}
@@ -0,0 +1,157 @@
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <array>
+#include <span>
+#include <functional>
+#include <utility>
+#include <cstdint>
+
+#include "component.h"
+#include "signature.h"
+
+namespace Byte {
+
+	enum class ObserverEvent : uint8_t {
+		ADD,
+		REMOVE,
+		DESTROY
+	};
+
+	template<typename _EntityID, size_t _MAX_COMPONENT_COUNT>
+	class Observers {
+	public:
+		inline static constexpr size_t MAX_COMPONENT_COUNT{ _MAX_COMPONENT_COUNT };
+		inline static constexpr size_t EVENT_COUNT{ 3 };
+
+		using EntityID = _EntityID;
+		using Signature = Byte::Signature<MAX_COMPONENT_COUNT>;
+		using Observer = std::function<void(std::span<const EntityID>)>;
+		using EntityVector = std::vector<EntityID>;
+
+	private:
+		struct Channel {
+			std::vector<ComponentID> observed;
+			// A deque keeps a running observer in place while it registers more observers.
+			std::vector<std::deque<Observer>> observers;
+			std::vector<EntityVector> pending;
+			std::vector<ComponentID> dirty;
+		};
+
+		std::array<Channel, EVENT_COUNT> _channels;
+		bool _active{ false };
+
+	public:
+		void observe(ObserverEvent event, ComponentID id, Observer observer) {
+			Channel& channel{ _channels[static_cast<size_t>(event)] };
+
+			if (id >= channel.observers.size()) {
+				channel.observers.resize(id + 1);
+				channel.pending.resize(id + 1);
+			}
+
+			if (channel.observers[id].empty()) {
+				channel.observed.push_back(id);
+			}
+			channel.observers[id].push_back(std::move(observer));
+			_active = true;
+		}
+
+		bool active() const {
+			return _active;
+		}
+
+		bool observes(ObserverEvent event, ComponentID id) const {
+			const Channel& channel{ _channels[static_cast<size_t>(event)] };
+			return id < channel.observers.size() && !channel.observers[id].empty();
+		}
+
+		bool observes(ObserverEvent event, const Signature& present, const Signature& absent) const {
+			for (ComponentID id : _channels[static_cast<size_t>(event)].observed) {
+				if (present.test(id) && !absent.test(id)) {
+					return true;
+				}
+			}
+			return false;
+		}
+
+		void record(ObserverEvent event, ComponentID id, EntityID entity) {
+			Channel& channel{ _channels[static_cast<size_t>(event)] };
+
+			EntityVector& pending{ channel.pending[id] };
+			if (pending.empty()) {
+				channel.dirty.push_back(id);
+			}
+			pending.push_back(entity);
+		}
+
+		void record(ObserverEvent event, const Signature& components, EntityID entity) {
+			for (ComponentID id : _channels[static_cast<size_t>(event)].observed) {
+				if (components.test(id)) {
+					record(event, id, entity);
+				}
+			}
+		}
+
+		void record(ObserverEvent event, const Signature& present, const Signature& absent, EntityID entity) {
+			each(event, present, absent, [&](ComponentID id) {
+				record(event, id, entity);
+			});
+		}
+
+		template<typename Entities>
+		void record(ObserverEvent event, const Signature& present, const Signature& absent, Entities&& entities) {
+			each(event, present, absent, [&](ComponentID id) {
+				for (EntityID entity : entities) {
+					record(event, id, entity);
+				}
+			});
+		}
+
+		void flush() {
+			bool delivered{ true };
+
+			while (delivered) {
+				delivered = false;
+
+				for (Channel& channel : _channels) {
+					std::vector<ComponentID> dirty{ std::move(channel.dirty) };
+					channel.dirty.clear();
+
+					for (ComponentID id : dirty) {
+						EntityVector entities{ std::move(channel.pending[id]) };
+						channel.pending[id].clear();
+
+						// Observers registered during delivery wait for the next batch.
+						size_t count{ channel.observers[id].size() };
+						for (size_t _index{}; _index < count; ++_index) {
+							channel.observers[id][_index](std::span<const EntityID>{ entities });
+						}
+						delivered = true;
+					}
+				}
+			}
+		}
+
+		void clear() {
+			for (Channel& channel : _channels) {
+				for (ComponentID id : channel.dirty) {
+					channel.pending[id].clear();
+				}
+				channel.dirty.clear();
+			}
+		}
+
+	private:
+		template<typename Function>
+		void each(ObserverEvent event, const Signature& present, const Signature& absent, Function&& function) const {
+			for (ComponentID id : _channels[static_cast<size_t>(event)].observed) {
+				if (present.test(id) && !absent.test(id)) {
+					function(id);
+				}
+			}
+		}
+	};
+
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#if defined(__SSE__) || defined(_M_X64) || defined(_M_IX86)
+#include <xmmintrin.h>
+#define BYTE_PREFETCH_SSE
+#endif
+
+namespace Byte {
+
+	inline void prefetch(const void* address) {
+#if defined(BYTE_PREFETCH_SSE)
+		_mm_prefetch(static_cast<const char*>(address), _MM_HINT_T0);
+#elif defined(__GNUC__)
+		__builtin_prefetch(address);
+#endif
+	}
+
+}
@@ -0,0 +1,248 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <functional>
+#include <atomic>
+#include <memory>
+#include <chrono>
+#include <type_traits>
+
+#include "component.h"
+#include "thread_pool.h"
+
+namespace Byte {
+
+	template<typename WorldType>
+	class Scheduler {
+	public:
+		using World = WorldType;
+		using Signature = typename World::Signature;
+		using EntityID = typename World::EntityID;
+		using SystemFunction = std::function<void(World&)>;
+		using Clock = std::chrono::steady_clock;
+
+		struct Access {
+			Signature reads;
+			Signature writes;
+
+			template<typename... Components>
+			Access& read() {
+				reads += Signature::template build<Components...>();
+				return *this;
+			}
+
+			template<typename... Components>
+			Access& write() {
+				writes += Signature::template build<Components...>();
+				return *this;
+			}
+
+			bool conflicts(const Access& other) const {
+				return writes.matches(other.reads + other.writes) || other.writes.matches(reads);
+			}
+
+			template<typename... Components>
+			static Access build() {
+				Access out;
+				(out.template add<Components>(), ...);
+				return out;
+			}
+
+		private:
+			template<typename Component>
+			void add() {
+				using Decayed = std::decay_t<Component>;
+
+				if constexpr (std::is_const_v<std::remove_reference_t<Component>> || std::is_same_v<Decayed, EntityID>) {
+					reads.set(Registry<Decayed>::id());
+				}
+				else {
+					writes.set(Registry<Decayed>::id());
+				}
+			}
+		};
+
+		struct SystemTiming {
+			double start{};
+			double time{};
+			double finish{};
+			bool critical{ false };
+		};
+
+	private:
+		struct System {
+			std::string name;
+			Access access;
+			SystemFunction function;
+			std::vector<size_t> next;
+			size_t dependencies{};
+			SystemTiming timing;
+		};
+
+		using SystemVector = std::vector<System>;
+
+		SystemVector _systems;
+		bool _dirty{ false };
+		double _frameTime{};
+		double _criticalPathTime{};
+
+	public:
+		template<typename... Components, typename Function>
+		size_t system(std::string name, Function&& function) {
+			return system(
+				std::move(name),
+				Access::template build<Components...>(),
+				[function = std::forward<Function>(function)](World& world) mutable {
+					auto view{ world.template components<Components...>() };
+					function(view);
+				});
+		}
+
+		size_t system(std::string name, Access access, SystemFunction function) {
+			_systems.push_back(System{ std::move(name), access, std::move(function) });
+			_dirty = true;
+			return _systems.size() - 1;
+		}
+
+		void run(World& world) {
+			if (_systems.empty()) {
+				return;
+			}
+
+			if (_dirty) {
+				build();
+			}
+
+			ThreadPool& pool{ world.threadPool() };
+
+			std::unique_ptr<std::atomic<size_t>[]> remaining{ new std::atomic<size_t>[_systems.size()] };
+			for (size_t _index{}; _index < _systems.size(); ++_index) {
+				remaining[_index].store(_systems[_index].dependencies);
+			}
+
+			std::atomic<size_t> finished{ 0 };
+			Clock::time_point frameStart{ Clock::now() };
+
+			std::function<void(size_t)> launch;
+			launch = [&](size_t _index) {
+				pool.submit([&, _index]() {
+					System& system{ _systems[_index] };
+
+					Clock::time_point start{ Clock::now() };
+					system.function(world);
+					Clock::time_point end{ Clock::now() };
+
+					system.timing.start = std::chrono::duration<double>(start - frameStart).count();
+					system.timing.time = std::chrono::duration<double>(end - start).count();
+
+					for (size_t next : system.next) {
+						if (remaining[next].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+							launch(next);
+						}
+					}
+
+					finished.fetch_add(1, std::memory_order_release);
+				});
+			};
+
+			for (size_t _index{}; _index < _systems.size(); ++_index) {
+				if (_systems[_index].dependencies == 0) {
+					launch(_index);
+				}
+			}
+
+			pool.wait([&]() {
+				return finished.load(std::memory_order_acquire) == _systems.size();
+			});
+
+			_frameTime = std::chrono::duration<double>(Clock::now() - frameStart).count();
+			measureCriticalPath();
+		}
+
+		size_t size() const {
+			return _systems.size();
+		}
+
+		const std::string& name(size_t system) const {
+			return _systems[system].name;
+		}
+
+		const SystemTiming& timing(size_t system) const {
+			return _systems[system].timing;
+		}
+
+		const std::vector<size_t>& dependents(size_t system) const {
+			return _systems[system].next;
+		}
+
+		double frameTime() const {
+			return _frameTime;
+		}
+
+		double criticalPathTime() const {
+			return _criticalPathTime;
+		}
+
+		std::vector<size_t> criticalPath() const {
+			std::vector<size_t> out;
+			for (size_t _index{}; _index < _systems.size(); ++_index) {
+				if (_systems[_index].timing.critical) {
+					out.push_back(_index);
+				}
+			}
+			return out;
+		}
+
+	private:
+		void build() {
+			for (System& system : _systems) {
+				system.next.clear();
+				system.dependencies = 0;
+			}
+
+			for (size_t last{}; last < _systems.size(); ++last) {
+				for (size_t first{}; first < last; ++first) {
+					if (_systems[first].access.conflicts(_systems[last].access)) {
+						_systems[first].next.push_back(last);
+						++_systems[last].dependencies;
+					}
+				}
+			}
+
+			_dirty = false;
+		}
+
+		void measureCriticalPath() {
+			std::vector<double> finish(_systems.size(), 0.0);
+			std::vector<size_t> previous(_systems.size(), _systems.size());
+
+			for (size_t _index{}; _index < _systems.size(); ++_index) {
+				System& system{ _systems[_index] };
+				finish[_index] += system.timing.time;
+				system.timing.finish = finish[_index];
+				system.timing.critical = false;
+
+				for (size_t next : system.next) {
+					if (finish[_index] > finish[next]) {
+						finish[next] = finish[_index];
+						previous[next] = _index;
+					}
+				}
+			}
+
+			size_t last{};
+			for (size_t _index{ 1 }; _index < _systems.size(); ++_index) {
+				if (finish[_index] > finish[last]) {
+					last = _index;
+				}
+			}
+
+			_criticalPathTime = finish[last];
+			for (size_t _index{ last }; _index < _systems.size(); _index = previous[_index]) {
+				_systems[_index].timing.critical = true;
+			}
+		}
+	};
+
+}
\ No newline at end of file
@@ -1,9 +1,14 @@
 #pragma once
 
-#include <bitset>
 #include <array>
+#include <bit>
 #include <cstdint>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define BYTE_SIGNATURE_SSE2
+#endif
+
 #include "component.h"
 
 namespace Byte {
@@ -15,55 +20,105 @@ namespace Byte {
 		inline static constexpr size_t BITSET_SIZE{ 64 };
 		inline static constexpr size_t BITSET_COUNT{ (MAX_COMPONENT_COUNT + BITSET_SIZE - 1) / BITSET_SIZE };
 
-		using Bitset = std::bitset<BITSET_SIZE>;
+		using Bitset = uint64_t;
 		using BitsetArray = std::array<Bitset, BITSET_COUNT>;
 
 	private:
-		BitsetArray _bitsets;
+		alignas(16) BitsetArray _bitsets{};
 
 	public:
 		void set(ComponentID id, bool value = true) {
-			_bitsets[id / BITSET_SIZE].set(id % BITSET_SIZE, value);
+			Bitset bit{ Bitset{ 1 } << (id % BITSET_SIZE) };
+			if (value) {
+				_bitsets[id / BITSET_SIZE] |= bit;
+			}
+			else {
+				_bitsets[id / BITSET_SIZE] &= ~bit;
+			}
 		}
 
 		bool test(ComponentID id) const {
-			return _bitsets[id / BITSET_SIZE].test(id % BITSET_SIZE);
+			return (_bitsets[id / BITSET_SIZE] >> (id % BITSET_SIZE)) & 1;
 		}
 
 		bool includes(const Signature& signature) const {
-			for (size_t _index{}; _index < BITSET_COUNT; ++_index) {
-				if ((_bitsets[_index] | signature._bitsets[_index]) != _bitsets[_index]) {
+#ifdef BYTE_SIGNATURE_SSE2
+			if constexpr (BITSET_COUNT % 2 == 0) {
+				// Component ids are handed out in registration order, so most rejections show up in the first lane.
+				__m128i missing{ _mm_andnot_si128(load(0), signature.load(0)) };
+				if (!isZero(missing)) {
 					return false;
 				}
+				for (size_t _index{ 2 }; _index < BITSET_COUNT; _index += 2) {
+					missing = _mm_or_si128(missing, _mm_andnot_si128(load(_index), signature.load(_index)));
+				}
+				return isZero(missing);
 			}
-			return true;
+#endif
+			Bitset missing{};
+			for (size_t _index{}; _index < BITSET_COUNT; ++_index) {
+				missing |= signature._bitsets[_index] & ~_bitsets[_index];
+			}
+			return missing == 0;
 		}
 
 		bool matches(const Signature& signature) const {
-			for (size_t _index{}; _index < BITSET_COUNT; ++_index) {
-				if ((_bitsets[_index] & signature._bitsets[_index]).any()) {
-					return true;
+#ifdef BYTE_SIGNATURE_SSE2
+			if constexpr (BITSET_COUNT % 2 == 0) {
+				__m128i common{ _mm_setzero_si128() };
+				for (size_t _index{}; _index < BITSET_COUNT; _index += 2) {
+					common = _mm_or_si128(common, _mm_and_si128(load(_index), signature.load(_index)));
 				}
+				return !isZero(common);
+			}
+#endif
+			Bitset common{};
+			for (size_t _index{}; _index < BITSET_COUNT; ++_index) {
+				common |= _bitsets[_index] & signature._bitsets[_index];
 			}
-			return false;
+			return common != 0;
 		}
 
 		bool any() const {
-			for (Bitset bitset: _bitsets) {
-				if (bitset.any()) {
-					return true;
+			Bitset out{};
+			for (Bitset bitset : _bitsets) {
+				out |= bitset;
+			}
+			return out != 0;
+		}
+
+		size_t count() const {
+			size_t out{};
+			for (Bitset bitset : _bitsets) {
+				out += std::popcount(bitset);
+			}
+			return out;
+		}
+
+		template<typename Function>
+		void each(Function&& function) const {
+			for (size_t _index{}; _index < BITSET_COUNT; ++_index) {
+				for (Bitset bitset{ _bitsets[_index] }; bitset; bitset &= bitset - 1) {
+					function(static_cast<ComponentID>(_index * BITSET_SIZE + std::countr_zero(bitset)));
 				}
 			}
-			return false;
 		}
 
 		bool operator==(const Signature& other) const {
-			for (size_t _index{}; _index < BITSET_COUNT; ++_index) {
-				if (_bitsets[_index] != other._bitsets[_index]) {
-					return false;
+#ifdef BYTE_SIGNATURE_SSE2
+			if constexpr (BITSET_COUNT % 2 == 0) {
+				__m128i difference{ _mm_setzero_si128() };
+				for (size_t _index{}; _index < BITSET_COUNT; _index += 2) {
+					difference = _mm_or_si128(difference, _mm_xor_si128(load(_index), other.load(_index)));
 				}
+				return isZero(difference);
 			}
-			return true;
+#endif
+			Bitset difference{};
+			for (size_t _index{}; _index < BITSET_COUNT; ++_index) {
+				difference |= _bitsets[_index] ^ other._bitsets[_index];
+			}
+			return difference == 0;
 		}
 
 		bool operator!=(const Signature& other) const {
@@ -85,6 +140,21 @@ namespace Byte {
 			return *this;
 		}
 
+		Signature operator-(const Signature& other) const {
+			Signature out;
+			for (size_t i{}; i < BITSET_COUNT; ++i) {
+				out._bitsets[i] = _bitsets[i] & ~other._bitsets[i];
+			}
+			return out;
+		}
+
+		Signature& operator-=(const Signature& other) {
+			for (size_t i{}; i < BITSET_COUNT; ++i) {
+				_bitsets[i] &= ~other._bitsets[i];
+			}
+			return *this;
+		}
+
 		const BitsetArray& data() const {
 			return _bitsets;
 		}
@@ -96,6 +166,17 @@ namespace Byte {
 			return out;
 		}
 
+	private:
+#ifdef BYTE_SIGNATURE_SSE2
+		__m128i load(size_t _index) const {
+			return _mm_load_si128(reinterpret_cast<const __m128i*>(_bitsets.data() + _index));
+		}
+
+		static bool isZero(__m128i value) {
+			return _mm_movemask_epi8(_mm_cmpeq_epi8(value, _mm_setzero_si128())) == 0xFFFF;
+		}
+#endif
+
 	};
 
 }
@@ -108,15 +189,18 @@ namespace std {
 		using Signature = Byte::Signature<MAX_COMPONENT_COUNT>;
 
 		size_t operator()(const Signature& signature) const {
-			size_t result{};
+			uint64_t result{ 0x9E3779B97F4A7C15ull };
 
 			for (size_t i{}; i < signature.BITSET_COUNT; ++i) {
-				result += signature.data()[i].to_ullong();
+				result = std::rotl(result ^ signature.data()[i], 29) * 0xBF58476D1CE4E5B9ull;
 			}
 
-			return result;
+			result ^= result >> 31;
+			result *= 0x94D049BB133111EBull;
+			result ^= result >> 29;
+
+			return static_cast<size_t>(result);
 		}
 	};
 
 }
-
@@ -0,0 +1,245 @@
+#pragma once
+
+#include <fstream>
+#include <string>
+#include <span>
+#include <vector>
+#include <cstring>
+#include <cstdint>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+#include <concepts>
+
+#include "component.h"
+
+namespace Byte {
+
+	inline constexpr uint64_t SNAPSHOT_MAGIC{ 0x3153434545545942ull };
+	inline constexpr uint32_t SNAPSHOT_VERSION{ 1 };
+	inline constexpr size_t SNAPSHOT_ALIGNMENT{ 64 };
+
+	class SnapshotWriter {
+	public:
+		struct Block {
+			size_t header;
+			size_t first;
+		};
+
+	private:
+		std::ofstream _stream;
+		std::vector<std::byte>* _buffer{ nullptr };
+		size_t _offset{};
+
+	public:
+		explicit SnapshotWriter(const std::string& path)
+			: _stream{ path, std::ios::binary | std::ios::trunc } {
+			if (!_stream) {
+				throw std::runtime_error("Cannot write " + path);
+			}
+		}
+
+		explicit SnapshotWriter(std::vector<std::byte>& buffer)
+			: _buffer{ &buffer }, _offset{ buffer.size() } {
+		}
+
+		void write(const void* data, size_t bytes) {
+			if (_buffer) {
+				const std::byte* first{ static_cast<const std::byte*>(data) };
+				_buffer->insert(_buffer->end(), first, first + bytes);
+			}
+			else {
+				_stream.write(static_cast<const char*>(data), static_cast<std::streamsize>(bytes));
+			}
+			_offset += bytes;
+		}
+
+		template<typename Value>
+		void value(const Value& data) {
+			static_assert(std::is_trivially_copyable_v<Value>, "Snapshot values are written as raw bytes");
+			write(&data, sizeof(Value));
+		}
+
+		void varint(uint64_t data) {
+			while (data >= 0x80) {
+				value(static_cast<uint8_t>(data | 0x80));
+				data >>= 7;
+			}
+			value(static_cast<uint8_t>(data));
+		}
+
+		void align(size_t alignment) {
+			static constexpr char zeros[SNAPSHOT_ALIGNMENT]{};
+			write(zeros, (alignment - _offset % alignment) % alignment);
+		}
+
+		Block begin(ComponentKey key, size_t count, bool raw) {
+			value(key);
+			value<uint64_t>(count);
+			value<uint64_t>(raw);
+
+			size_t header{ _offset };
+			value<uint64_t>(0);
+			align(SNAPSHOT_ALIGNMENT);
+
+			return Block{ header, _offset };
+		}
+
+		void end(const Block& block) {
+			uint64_t bytes{ _offset - block.first };
+
+			if (_buffer) {
+				std::memcpy(_buffer->data() + block.header, &bytes, sizeof(bytes));
+				return;
+			}
+
+			_stream.seekp(static_cast<std::streamoff>(block.header));
+			_stream.write(reinterpret_cast<const char*>(&bytes), sizeof(bytes));
+			_stream.seekp(static_cast<std::streamoff>(_offset));
+		}
+	};
+
+	struct SnapshotBlock {
+		ComponentKey key;
+		size_t count;
+		bool raw;
+		std::span<const std::byte> bytes;
+	};
+
+	class SnapshotReader {
+	private:
+		const std::byte* _data;
+		size_t _size;
+		size_t _offset{};
+
+	public:
+		SnapshotReader(const std::byte* data, size_t size)
+			: _data{ data }, _size{ size } {
+		}
+
+		explicit SnapshotReader(std::span<const std::byte> bytes)
+			: SnapshotReader{ bytes.data(), bytes.size() } {
+		}
+
+		template<typename Value>
+		Value value() {
+			static_assert(std::is_trivially_copyable_v<Value>, "Snapshot values are read as raw bytes");
+
+			Value out;
+			std::memcpy(&out, bytes(sizeof(Value)).data(), sizeof(Value));
+			return out;
+		}
+
+		uint64_t varint() {
+			uint64_t out{};
+			for (size_t shift{}; shift < 64; shift += 7) {
+				uint8_t byte{ value<uint8_t>() };
+				out |= static_cast<uint64_t>(byte & 0x7F) << shift;
+				if (!(byte & 0x80)) {
+					return out;
+				}
+			}
+			throw std::runtime_error("Snapshot varint is malformed");
+		}
+
+		std::span<const std::byte> bytes(size_t count) {
+			if (count > _size - _offset) {
+				throw std::runtime_error("Snapshot is truncated");
+			}
+
+			std::span<const std::byte> out{ _data + _offset, count };
+			_offset += count;
+			return out;
+		}
+
+		void align(size_t alignment) {
+			_offset = std::min(_size, _offset + (alignment - _offset % alignment) % alignment);
+		}
+
+		SnapshotBlock block() {
+			SnapshotBlock out{};
+			out.key = value<ComponentKey>();
+			out.count = static_cast<size_t>(value<uint64_t>());
+			out.raw = value<uint64_t>() != 0;
+
+			size_t length{ static_cast<size_t>(value<uint64_t>()) };
+			align(SNAPSHOT_ALIGNMENT);
+			out.bytes = bytes(length);
+
+			return out;
+		}
+	};
+
+	template<typename Component>
+	struct Serializer;
+
+	template<typename Component>
+	inline constexpr bool SERIALIZABLE{
+		requires(SnapshotWriter& writer, SnapshotReader& reader, const Component& component) {
+			Serializer<Component>::save(writer, component);
+			{ Serializer<Component>::load(reader) } -> std::convertible_to<Component>;
+		} };
+
+	template<typename Component, typename Rows>
+	void saveColumn(SnapshotWriter& writer, size_t count, size_t blockSize, Rows&& rows) {
+		constexpr bool raw{ std::is_trivially_copyable_v<Component> };
+
+		if constexpr (!raw && !SERIALIZABLE<Component>) {
+			throw std::logic_error("Component needs a Serializer specialization to be saved");
+		}
+		else {
+			SnapshotWriter::Block block{ writer.begin(Registry<Component>::key(), count, raw) };
+
+			for (size_t first{}; first < count;) {
+				size_t length{ std::min(blockSize, count - first) };
+				const Component* data{ rows(first) };
+
+				if constexpr (raw) {
+					writer.write(data, length * sizeof(Component));
+				}
+				else {
+					for (size_t _index{}; _index < length; ++_index) {
+						Serializer<Component>::save(writer, data[_index]);
+					}
+				}
+				first += length;
+			}
+
+			writer.end(block);
+		}
+	}
+
+	template<typename Component, typename ComponentContainer>
+	void loadColumn(const SnapshotBlock& block, ComponentContainer& container) {
+		constexpr bool raw{ std::is_trivially_copyable_v<Component> };
+
+		if (block.key != Registry<Component>::key() || block.raw != raw) {
+			throw std::runtime_error("Snapshot column does not match its component");
+		}
+
+		if constexpr (raw) {
+			if (block.bytes.size() != block.count * sizeof(Component)) {
+				throw std::runtime_error("Snapshot column is truncated");
+			}
+
+			const Component* first{ reinterpret_cast<const Component*>(block.bytes.data()) };
+			if constexpr (requires { container.append(first, block.count); }) {
+				container.append(first, block.count);
+			}
+			else {
+				container.insert(container.end(), first, first + block.count);
+			}
+		}
+		else if constexpr (SERIALIZABLE<Component>) {
+			SnapshotReader reader{ block.bytes };
+			container.reserve(container.size() + block.count);
+			for (size_t _index{}; _index < block.count; ++_index) {
+				container.push_back(Serializer<Component>::load(reader));
+			}
+		}
+		else {
+			throw std::logic_error("Component needs a Serializer specialization to be loaded");
+		}
+	}
+
+}
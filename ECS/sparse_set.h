@@ -0,0 +1,215 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <memory_resource>
+#include <utility>
+#include <span>
+#include <stdexcept>
+
+#include "component.h"
+#include "snapshot.h"
+#include "delta.h"
+
+namespace Byte {
+
+	template<typename EntityID, typename IndexMap>
+	class ISparseSet;
+
+	template<typename EntityID, typename IndexMap>
+	using USparseSet = std::unique_ptr<ISparseSet<EntityID, IndexMap>>;
+
+	template<typename EntityID, typename Component, typename IndexMap>
+	class SparseSet;
+
+	template<typename EntityID, typename IndexMap>
+	class ISparseSet {
+	protected:
+		std::pmr::memory_resource* _resource;
+		std::pmr::vector<EntityID> _entities;
+		IndexMap _indices;
+
+	public:
+		explicit ISparseSet(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+			: _resource{ resource }, _entities{ resource }, _indices{ typename IndexMap::allocator_type{ resource } } {
+		}
+
+		// Copies draw from the same resource as the original rather than the default one.
+		ISparseSet(const ISparseSet& left)
+			: ISparseSet{ left._resource } {
+			_entities = left._entities;
+			_indices = left._indices;
+		}
+
+		virtual ~ISparseSet() = default;
+
+		virtual USparseSet<EntityID, IndexMap> copy() const = 0;
+
+		virtual bool erase(EntityID id) = 0;
+
+		virtual bool copyEntity(EntityID from, EntityID to) = 0;
+
+		virtual void save(SnapshotWriter& writer) const = 0;
+
+		virtual void load(SnapshotReader& reader) = 0;
+
+		virtual bool diff(EntityID id, const ISparseSet* base, std::vector<std::byte>& out) const = 0;
+
+		virtual bool patch(EntityID id, SnapshotReader& reader) = 0;
+
+		bool contains(EntityID id) const {
+			return _indices.find(id) != _indices.end();
+		}
+
+		size_t size() const {
+			return _entities.size();
+		}
+
+		std::span<const EntityID> entities() const {
+			return _entities;
+		}
+
+		template<typename Component>
+		SparseSet<EntityID, Component, IndexMap>& receive() {
+			return *static_cast<SparseSet<EntityID, Component, IndexMap>*>(this);
+		}
+
+		template<typename Component>
+		const SparseSet<EntityID, Component, IndexMap>& receive() const {
+			return *static_cast<const SparseSet<EntityID, Component, IndexMap>*>(this);
+		}
+
+	};
+
+	template<typename EntityID, typename Component, typename IndexMap>
+	class SparseSet : public ISparseSet<EntityID, IndexMap> {
+	private:
+		std::pmr::vector<Component> _components;
+
+	public:
+		explicit SparseSet(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+			: ISparseSet<EntityID, IndexMap>{ resource }, _components{ resource } {
+		}
+
+		SparseSet(const SparseSet& left)
+			: ISparseSet<EntityID, IndexMap>{ left }, _components{ left._components, left._resource } {
+		}
+
+		USparseSet<EntityID, IndexMap> copy() const override {
+			return std::make_unique<SparseSet>(*this);
+		}
+
+		template<typename _Component>
+		bool emplace(EntityID id, _Component&& component) {
+			auto result{ this->_indices.find(id) };
+			if (result != this->_indices.end()) {
+				_components[result->second] = std::forward<_Component>(component);
+				return false;
+			}
+
+			this->_indices.emplace(id, this->_entities.size());
+			this->_entities.push_back(id);
+			_components.push_back(std::forward<_Component>(component));
+			return true;
+		}
+
+		bool erase(EntityID id) override {
+			auto result{ this->_indices.find(id) };
+			if (result == this->_indices.end()) {
+				return false;
+			}
+
+			size_t _index{ result->second };
+			size_t lastIndex{ this->_entities.size() - 1 };
+
+			if (_index != lastIndex) {
+				EntityID last{ this->_entities[lastIndex] };
+				this->_entities[_index] = last;
+				_components[_index] = std::move(_components[lastIndex]);
+				this->_indices.at(last) = _index;
+			}
+
+			this->_entities.pop_back();
+			_components.pop_back();
+			this->_indices.erase(id);
+			return true;
+		}
+
+		bool copyEntity(EntityID from, EntityID to) override {
+			if (!this->contains(from)) {
+				return false;
+			}
+
+			Component component{ get(from) };
+			return emplace(to, std::move(component));
+		}
+
+		void save(SnapshotWriter& writer) const override {
+			saveColumn<EntityID>(writer, this->_entities.size(), this->_entities.size(), [this](size_t first) {
+				return this->_entities.data() + first;
+			});
+			saveColumn<Component>(writer, _components.size(), _components.size(), [this](size_t first) {
+				return _components.data() + first;
+			});
+		}
+
+		void load(SnapshotReader& reader) override {
+			SnapshotBlock entities{ reader.block() };
+			SnapshotBlock components{ reader.block() };
+
+			size_t first{ this->_entities.size() };
+			loadColumn<EntityID>(entities, this->_entities);
+			loadColumn<Component>(components, _components);
+
+			if (this->_entities.size() != _components.size()) {
+				throw std::runtime_error("Snapshot sparse set columns differ in length");
+			}
+
+			for (size_t _index{ first }; _index < this->_entities.size(); ++_index) {
+				this->_indices.emplace(this->_entities[_index], _index);
+			}
+		}
+
+		bool diff(EntityID id, const ISparseSet<EntityID, IndexMap>* base, std::vector<std::byte>& out) const override {
+			const SparseSet* castedBase{ static_cast<const SparseSet*>(base) };
+			return diffComponent(get(id), castedBase ? castedBase->find(id) : nullptr, out);
+		}
+
+		bool patch(EntityID id, SnapshotReader& reader) override {
+			Component* component{ find(id) };
+			bool added{ !component };
+
+			if (added) {
+				emplace(id, defaultComponent<Component>());
+				component = &_components.back();
+			}
+
+			patchComponent(*component, reader);
+			return added;
+		}
+
+		Component& get(EntityID id) {
+			return _components[this->_indices.at(id)];
+		}
+
+		const Component& get(EntityID id) const {
+			return _components[this->_indices.at(id)];
+		}
+
+		Component* find(EntityID id) {
+			auto result{ this->_indices.find(id) };
+			return result == this->_indices.end() ? nullptr : &_components[result->second];
+		}
+
+		const Component* find(EntityID id) const {
+			auto result{ this->_indices.find(id) };
+			return result == this->_indices.end() ? nullptr : &_components[result->second];
+		}
+
+		std::span<Component> components() {
+			return _components;
+		}
+
+	};
+
+}
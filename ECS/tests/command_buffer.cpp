@@ -0,0 +1,219 @@
+#include "../ecs.h"
+#include "test.h"
+
+#include <memory>
+#include <vector>
+#include <algorithm>
+
+using namespace Byte;
+
+struct Position {
+    float x{}, y{};
+};
+
+struct Velocity {
+    float x{}, y{};
+};
+
+struct Frozen {};
+
+struct Marker {
+    int value{};
+};
+
+template<>
+inline constexpr bool Byte::SPARSE_STORAGE<Marker> = true;
+
+// Several commands for one entity collapse into a single migration that ends in the last state recorded.
+template<typename WorldType>
+void coalesced() {
+    WorldType world;
+    auto a{ world.create(Position{ 1, 1 }) };
+    auto b{ world.create(Position{ 2, 2 }, Velocity{ 2, 2 }) };
+
+    CommandBuffer<WorldType> buffer{ world };
+    buffer.attach(a, Velocity{ 3, 3 });
+    buffer.attach(a, Frozen{});
+    buffer.attach(a, Velocity{ 4, 4 });
+    buffer.attach(b, Position{ 5, 5 });
+    buffer.template detach<Velocity>(b);
+    buffer.attach(b, Frozen{});
+    world.apply(buffer);
+
+    CHECK(buffer.empty());
+    CHECK(world.template get<Velocity>(a).x == 4);
+    CHECK(world.template get<Position>(a).x == 1);
+    CHECK(world.template has<Frozen>(a));
+    CHECK(world.template get<Position>(b).x == 5);
+    CHECK(!world.template has<Velocity>(b));
+    CHECK(world.template has<Frozen>(b));
+    CHECK(world.size() == 2);
+}
+
+// An entity created and destroyed in the same buffer never appears, whatever was attached in between.
+template<typename WorldType>
+void createdAndDestroyed() {
+    WorldType world;
+    auto kept{ world.create(Position{ 1, 1 }) };
+
+    CommandBuffer<WorldType> buffer{ world };
+    auto transient{ buffer.create(Position{ 2, 2 }, Marker{ 2 }) };
+    buffer.attach(transient, Velocity{});
+    buffer.destroy(transient);
+    buffer.attach(transient, Frozen{});
+    auto created{ buffer.create(Position{ 3, 3 }) };
+    world.apply(buffer);
+
+    CHECK(world.size() == 2);
+    CHECK(world.template get<Position>(kept).x == 1);
+    CHECK(world.template get<Position>(created).x == 3);
+
+    size_t rows{};
+    world.template components<const Position>().each([&](const Position&) {
+        ++rows;
+    });
+    CHECK(rows == 2);
+
+    size_t markers{};
+    world.template components<const Marker>().each([&](const Marker&) {
+        ++markers;
+    });
+    CHECK(markers == 0);
+}
+
+// Detaching after attaching in the same buffer leaves the entity without the component, and vice versa.
+template<typename WorldType>
+void attachThenDetach() {
+    WorldType world;
+    auto a{ world.create(Position{ 1, 1 }) };
+    auto b{ world.create(Position{ 2, 2 }, Velocity{ 2, 2 }) };
+
+    CommandBuffer<WorldType> buffer{ world };
+    buffer.attach(a, Velocity{ 3, 3 });
+    buffer.template detach<Velocity>(a);
+    buffer.template detach<Velocity>(b);
+    buffer.attach(b, Velocity{ 6, 6 });
+    world.apply(buffer);
+
+    CHECK(!world.template has<Velocity>(a));
+    CHECK(world.template get<Position>(a).x == 1);
+    CHECK(world.template get<Velocity>(b).x == 6);
+    CHECK(world.template get<Position>(b).x == 2);
+}
+
+// Sparse commands recorded before a DESTROY are dropped with the entity; those on other entities still apply.
+template<typename WorldType>
+void sparseAgainstDestroy() {
+    WorldType world;
+    auto a{ world.create(Position{ 1, 1 }) };
+    auto b{ world.create(Position{ 2, 2 }) };
+    world.attach(b, Marker{ 1 });
+
+    CommandBuffer<WorldType> buffer{ world };
+    buffer.attach(a, Marker{ 5 });
+    buffer.destroy(a);
+    buffer.attach(b, Marker{ 7 });
+    buffer.template detach<Marker>(b);
+    buffer.attach(b, Marker{ 9 });
+    world.apply(buffer);
+
+    CHECK(world.size() == 1);
+    CHECK(world.template get<Marker>(b).value == 9);
+
+    size_t markers{};
+    world.template components<const Marker>().each([&](const Marker&) {
+        ++markers;
+    });
+    CHECK(markers == 1);
+
+    // A ParallelCommandBuffer plays its sparse commands back the same way.
+    ParallelCommandBuffer<WorldType> parallel{ world };
+    parallel.local().template detach<Marker>(b);
+    world.apply(parallel);
+    CHECK(!world.template has<Marker>(b));
+    CHECK(world.template get<Position>(b).x == 2);
+}
+
+bool distinct(std::vector<DenseEntityID> ids) {
+    std::sort(ids.begin(), ids.end(), [](DenseEntityID left, DenseEntityID right) {
+        return static_cast<uint64_t>(left) < static_cast<uint64_t>(right);
+    });
+    return std::adjacent_find(ids.begin(), ids.end()) == ids.end();
+}
+
+// Dense ids recorded from workers are reserved without touching the entity table the workers are reading.
+void reservedFromWorkers() {
+    DenseWorld world;
+    std::vector<DenseEntityID> existing;
+    for (int i{}; i < 4000; ++i) {
+        existing.push_back(world.create(Position{ float(i) }));
+    }
+    world.threadPool(std::make_shared<ThreadPool>(4));
+
+    ParallelCommandBuffer<DenseWorld> buffer{ world };
+    world.components<DenseEntityID, const Position>().parallelEach([&](DenseEntityID id, const Position& position) {
+        if (world.has<Position>(id) && world.get<Position>(id).x == position.x) {
+            buffer.local().create(Velocity{ position.x });
+        }
+    }, 64);
+
+    // The main thread keeps creating while the reservations are outstanding.
+    std::vector<DenseEntityID> created;
+    for (int i{}; i < 100; ++i) {
+        created.push_back(world.create(Position{ -1.0f }));
+    }
+
+    world.apply(buffer);
+    CHECK(world.size() == 8100);
+
+    std::vector<DenseEntityID> all{ existing };
+    all.insert(all.end(), created.begin(), created.end());
+    world.components<DenseEntityID, const Velocity>().each([&](DenseEntityID id, const Velocity&) {
+        all.push_back(id);
+    });
+    CHECK(all.size() == 8100);
+    CHECK(distinct(all));
+    for (DenseEntityID id : created) {
+        CHECK(world.get<Position>(id).x == -1.0f);
+    }
+}
+
+// Reservations that are never applied go back to the table, under a new generation.
+void clearedReservations() {
+    DenseWorld world;
+    CommandBuffer<DenseWorld> buffer{ world };
+
+    std::vector<DenseEntityID> reserved;
+    for (int i{}; i < 10; ++i) {
+        reserved.push_back(buffer.create(Position{}));
+    }
+    buffer.clear();
+    CHECK(buffer.empty());
+    CHECK(world.size() == 0);
+
+    std::vector<DenseEntityID> created;
+    for (int i{}; i < 10; ++i) {
+        created.push_back(world.create(Position{ float(i) }));
+    }
+    for (DenseEntityID id : created) {
+        CHECK(id.index < 10);
+        CHECK(std::find(reserved.begin(), reserved.end(), id) == reserved.end());
+    }
+    CHECK(distinct(created));
+    CHECK(world.size() == 10);
+}
+
+int main() {
+    Test::run("coalesced", coalesced<World>);
+    Test::run("coalesced dense", coalesced<DenseWorld>);
+    Test::run("createdAndDestroyed", createdAndDestroyed<World>);
+    Test::run("createdAndDestroyed dense", createdAndDestroyed<DenseWorld>);
+    Test::run("attachThenDetach", attachThenDetach<World>);
+    Test::run("attachThenDetach dense", attachThenDetach<DenseWorld>);
+    Test::run("sparseAgainstDestroy", sparseAgainstDestroy<World>);
+    Test::run("sparseAgainstDestroy dense", sparseAgainstDestroy<DenseWorld>);
+    Test::run("reservedFromWorkers", reservedFromWorkers);
+    Test::run("clearedReservations", clearedReservations);
+
+    return Test::finish();
+}
@@ -0,0 +1,228 @@
+#include "../ecs.h"
+#include "test.h"
+
+#include <vector>
+
+using namespace Byte;
+
+struct Position {
+    float x{}, y{};
+};
+
+struct Velocity {
+    float x{}, y{};
+};
+
+struct Frozen {};
+
+struct Health {
+    int value{};
+};
+
+template<>
+inline constexpr bool Byte::TRACK_CHANGES<Health> = true;
+
+template<typename WorldType>
+size_t count(WorldType& world) {
+    size_t rows{};
+    world.template components<const Position>().each([&](const Position&) {
+        ++rows;
+    });
+    return rows;
+}
+
+// Repeated IDs destroy the entity once and leave the others in place.
+template<typename WorldType>
+void duplicates() {
+    using EntityID = typename WorldType::EntityID;
+
+    WorldType world;
+    std::vector<EntityID> ids;
+    for (int i{}; i < 10; ++i) {
+        ids.push_back(world.create(Position{ float(i), 0 }));
+    }
+    auto empty{ world.create() };
+
+    std::vector<EntityID> doomed{ ids[2], ids[2], ids[7], empty, ids[7], empty, ids[2] };
+    world.destroyMany(doomed);
+
+    CHECK(world.size() == 8);
+    CHECK(count(world) == 8);
+    for (int i{}; i < 10; ++i) {
+        if (i != 2 && i != 7) {
+            CHECK(world.template get<Position>(ids[i]).x == float(i));
+        }
+    }
+}
+
+// Rows moved from the tail into the holes keep resolving to their own entities.
+template<typename WorldType>
+void tailFill() {
+    using EntityID = typename WorldType::EntityID;
+
+    WorldType world;
+    std::vector<EntityID> ids;
+    for (int i{}; i < 200; ++i) {
+        ids.push_back(world.create(Position{ float(i), 0 }, Velocity{ 0, float(i) }));
+    }
+
+    // A few rows, sorted by comparison.
+    std::vector<EntityID> few{ ids[199], ids[0], ids[150], ids[198] };
+    world.destroyMany(few);
+
+    // Most of the remaining rows, sorted by slot.
+    std::vector<EntityID> most;
+    for (int i{ 1 }; i < 150; ++i) {
+        if (i % 3) {
+            most.push_back(ids[i]);
+        }
+    }
+    world.destroyMany(most);
+
+    std::vector<bool> alive(200, true);
+    for (int i : { 199, 0, 150, 198 }) {
+        alive[i] = false;
+    }
+    for (int i{ 1 }; i < 150; ++i) {
+        if (i % 3) {
+            alive[i] = false;
+        }
+    }
+
+    size_t expected{};
+    for (int i{}; i < 200; ++i) {
+        if (alive[i]) {
+            ++expected;
+            CHECK(world.template get<Position>(ids[i]).x == float(i));
+            CHECK(world.template get<Velocity>(ids[i]).y == float(i));
+        }
+    }
+    CHECK(world.size() == expected);
+    CHECK(count(world) == expected);
+
+    // Destroying from the rebuilt rows still finds the right entities.
+    std::vector<EntityID> rest;
+    for (int i{}; i < 200; i += 2) {
+        if (alive[i]) {
+            rest.push_back(ids[i]);
+            alive[i] = false;
+            --expected;
+        }
+    }
+    world.destroyMany(rest);
+    for (int i{}; i < 200; ++i) {
+        if (alive[i]) {
+            CHECK(world.template get<Position>(ids[i]).x == float(i));
+        }
+    }
+    CHECK(world.size() == expected);
+}
+
+// Archetypes fully covered by the view are cleared at once; entities outside it are untouched.
+template<typename WorldType>
+void wholeArchetypes() {
+    using EntityID = typename WorldType::EntityID;
+
+    WorldType world;
+    std::vector<EntityID> moving, frozen, still;
+    for (int i{}; i < 32; ++i) {
+        moving.push_back(world.create(Position{ float(i), 0 }, Velocity{}));
+        frozen.push_back(world.create(Position{ float(i), 0 }, Velocity{}, Frozen{}));
+        still.push_back(world.create(Position{ float(i), 0 }));
+    }
+
+    size_t destroyed{};
+    world.template onDestroy<Velocity>([&](std::span<const EntityID> ids) {
+        destroyed += ids.size();
+    });
+
+    auto view{ world.template components<Velocity>() };
+    world.destroyAll(view);
+    world.flush();
+
+    CHECK(destroyed == 64);
+    CHECK(world.size() == 32);
+    CHECK(count(world) == 32);
+    for (int i{}; i < 32; ++i) {
+        CHECK(world.template get<Position>(still[i]).x == float(i));
+    }
+
+    // The cleared archetypes take new entities again.
+    auto again{ world.create(Position{ 7, 7 }, Velocity{ 1, 1 }) };
+    CHECK(world.template get<Velocity>(again).x == 1);
+    CHECK(world.size() == 33);
+}
+
+// A filtered view destroys only the rows that pass the filter.
+template<typename WorldType>
+void filtered() {
+    using EntityID = typename WorldType::EntityID;
+
+    WorldType world;
+    std::vector<EntityID> ids;
+    for (int i{}; i < 20; ++i) {
+        ids.push_back(world.create(Health{ i }, Position{ float(i), 0 }));
+    }
+
+    Tick since{ world.advance() };
+    world.advance();
+    world.template get<Health>(ids[4]).value = 0;
+    world.template get<Health>(ids[19]).value = 0;
+
+    auto changed{ world.template components<Health>().template filter<Changed<Health>>(since) };
+    world.destroyAll(changed);
+
+    CHECK(world.size() == 18);
+    for (int i{}; i < 20; ++i) {
+        if (i != 4 && i != 19) {
+            CHECK(world.template get<Health>(ids[i]).value == i);
+            CHECK(world.template get<Position>(ids[i]).x == float(i));
+        }
+    }
+}
+
+template<typename WorldType>
+void predicate() {
+    using EntityID = typename WorldType::EntityID;
+
+    WorldType world;
+    std::vector<EntityID> ids;
+    for (int i{}; i < 50; ++i) {
+        ids.push_back(world.create(Position{ float(i), 0 }, Velocity{ float(i % 5), 0 }));
+    }
+
+    auto view{ world.template components<Position, Velocity>() };
+    world.destroyIf(view, [](Position&, Velocity& velocity) {
+        return velocity.x == 0;
+    });
+    CHECK(world.size() == 40);
+
+    // The predicate may also take the entity.
+    EntityID target{ ids[13] };
+    world.destroyIf(view, [target](EntityID id, Position&, Velocity&) {
+        return id == target;
+    });
+    CHECK(world.size() == 39);
+
+    for (int i{}; i < 50; ++i) {
+        if (i % 5 && i != 13) {
+            CHECK(world.template get<Position>(ids[i]).x == float(i));
+            CHECK(world.template get<Velocity>(ids[i]).x == float(i % 5));
+        }
+    }
+}
+
+int main() {
+    Test::run("duplicates", duplicates<World>);
+    Test::run("duplicates dense", duplicates<DenseWorld>);
+    Test::run("tailFill", tailFill<World>);
+    Test::run("tailFill dense", tailFill<DenseWorld>);
+    Test::run("tailFill chunked", tailFill<ChunkedWorld>);
+    Test::run("wholeArchetypes", wholeArchetypes<World>);
+    Test::run("wholeArchetypes dense", wholeArchetypes<DenseWorld>);
+    Test::run("filtered", filtered<World>);
+    Test::run("predicate", predicate<World>);
+    Test::run("predicate dense", predicate<DenseWorld>);
+
+    return Test::finish();
+}
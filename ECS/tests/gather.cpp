@@ -0,0 +1,100 @@
+#include "../ecs.h"
+#include "test.h"
+
+#include <map>
+#include <random>
+#include <vector>
+#include <algorithm>
+
+using namespace Byte;
+
+struct Position {
+    float x{}, y{};
+};
+
+struct Velocity {
+    float x{}, y{};
+};
+
+struct Mass {
+    float value{};
+};
+
+using Visits = std::map<uint64_t, std::pair<float, float>>;
+
+// gather and gatherGrouped visit exactly the ids that have every requested component, with the values get() returns.
+void agreement() {
+    World world;
+    std::vector<EntityID> ids;
+    for (size_t i{}; i < 1000; ++i) {
+        float value{ static_cast<float>(i) };
+        switch (i % 4) {
+        case 0: ids.push_back(world.create(Position{ value }, Velocity{ 0.0f, -value })); break;
+        case 1: ids.push_back(world.create(Position{ value }, Velocity{ 0.0f, -value }, Mass{})); break;
+        case 2: ids.push_back(world.create(Position{ value })); break;
+        default: ids.push_back(world.create(Velocity{ 0.0f, -value }, Mass{})); break;
+        }
+    }
+
+    std::vector<bool> alive(ids.size(), true);
+    for (size_t i{}; i < ids.size(); i += 7) {
+        world.destroy(ids[i]);
+        alive[i] = false;
+    }
+
+    std::vector<EntityID> live;
+    for (size_t i{}; i < ids.size(); ++i) {
+        if (alive[i]) {
+            live.push_back(ids[i]);
+        }
+    }
+
+    std::mt19937_64 engine{ 17 };
+    std::shuffle(ids.begin(), ids.end(), engine);
+
+    Visits expected;
+    for (EntityID id : live) {
+        if (world.has<Position>(id) && world.has<Velocity>(id)) {
+            expected[id.id] = { world.get<Position>(id).x, world.get<Velocity>(id).y };
+        }
+    }
+    CHECK(!expected.empty());
+
+    Visits gathered;
+    size_t calls{};
+    world.gather<const Position, const Velocity>(ids, [&](EntityID id, const Position& position, const Velocity& velocity) {
+        gathered[id.id] = { position.x, velocity.y };
+        ++calls;
+    });
+    CHECK(gathered == expected);
+    CHECK(calls == expected.size());
+
+    Visits grouped;
+    calls = 0;
+    world.gatherGrouped<const Position, const Velocity>(ids, [&](EntityID id, const Position& position, const Velocity& velocity) {
+        grouped[id.id] = { position.x, velocity.y };
+        ++calls;
+    });
+    CHECK(grouped == expected);
+    CHECK(calls == expected.size());
+
+    // Writes through a mutable gather land on the same rows get() reads.
+    world.gather<Position>(ids, [](Position& position) {
+        position.y = position.x + 1.0f;
+    });
+    for (EntityID id : live) {
+        if (world.has<Position>(id)) {
+            CHECK(world.get<Position>(id).y == world.get<Position>(id).x + 1.0f);
+        }
+    }
+
+    world.gather<const Position>(std::span<const EntityID>{}, [&](const Position&) {
+        CHECK(false);
+    });
+}
+
+int main() {
+    Test::run("agreement", agreement);
+
+    return Test::finish();
+}
@@ -0,0 +1,146 @@
+#include "../hash_map.h"
+#include "test.h"
+
+#include <cstdint>
+#include <random>
+#include <vector>
+#include <algorithm>
+#include <unordered_map>
+
+using namespace Byte;
+
+// Low-entropy hash, so long probe runs, full groups and tombstone reuse get exercised.
+struct Colliding {
+    size_t operator()(uint64_t key) const {
+        return static_cast<size_t>(key % 61);
+    }
+};
+
+template<typename Map>
+bool same(const Map& map, const std::unordered_map<uint64_t, uint64_t>& reference) {
+    if (map.size() != reference.size()) {
+        return false;
+    }
+
+    size_t visited{};
+    for (const auto& [key, value] : map) {
+        auto result{ reference.find(key) };
+        if (result == reference.end() || result->second != value) {
+            return false;
+        }
+        ++visited;
+    }
+    return visited == reference.size();
+}
+
+// Random interleaving of inserts, overwrites, erases, lookups and batch lookups against std::unordered_map.
+// The key range is small relative to the step count, so the table repeatedly grows, fills with erased slots and shrinks.
+template<typename Map>
+void differential(uint64_t seed, uint64_t range, size_t steps) {
+    std::mt19937_64 engine{ seed };
+    Map map;
+    std::unordered_map<uint64_t, uint64_t> reference;
+
+    for (size_t step{}; step < steps; ++step) {
+        uint64_t key{ engine() % range };
+        uint64_t value{ engine() };
+
+        // Phases of 10000 steps alternate between insert-heavy and erase-heavy, so the size sweeps up and down.
+        size_t operation{ engine() % 10 };
+        bool growing{ step % 20000 < 10000 };
+
+        if (operation < (growing ? 5u : 1u)) {
+            if (reference.contains(key)) {
+                map.at(key) = value;
+            }
+            else {
+                map.emplace(key, value);
+            }
+            reference[key] = value;
+        }
+        else if (operation < (growing ? 6u : 1u)) {
+            map[key] = value;
+            reference[key] = value;
+        }
+        else if (operation < 9) {
+            map.erase(key);
+            reference.erase(key);
+        }
+        else {
+            auto result{ map.find(key) };
+            auto expected{ reference.find(key) };
+            CHECK((result == map.end()) == (expected == reference.end()));
+            if (result != map.end() && expected != reference.end()) {
+                CHECK(result->second == expected->second);
+            }
+        }
+
+        if (step % 997 == 0) {
+            CHECK(same(map, reference));
+        }
+    }
+    CHECK(same(map, reference));
+
+    std::vector<uint64_t> keys(range);
+    for (uint64_t key{}; key < range; ++key) {
+        keys[key] = key;
+    }
+    std::shuffle(keys.begin(), keys.end(), engine);
+
+    std::vector<uint64_t*> values(keys.size());
+    map.find_batch(std::span<const uint64_t>{ keys }, std::span<uint64_t*>{ values });
+    for (size_t idx{}; idx < keys.size(); ++idx) {
+        auto expected{ reference.find(keys[idx]) };
+        CHECK((values[idx] == nullptr) == (expected == reference.end()));
+        if (values[idx] && expected != reference.end()) {
+            CHECK(*values[idx] == expected->second);
+        }
+    }
+
+    bool thrown{ false };
+    try {
+        map.at(range + 1);
+    }
+    catch (const std::out_of_range&) {
+        thrown = true;
+    }
+    CHECK(thrown);
+
+    // Erase everything, then rebuild from empty.
+    for (uint64_t key : keys) {
+        map.erase(key);
+    }
+    CHECK(map.size() == 0);
+    CHECK(map.find(keys.front()) == map.end());
+
+    reference.clear();
+    for (uint64_t key : keys) {
+        map.emplace(key, key * 3);
+        reference[key] = key * 3;
+    }
+    CHECK(same(map, reference));
+
+    map.clear();
+    CHECK(map.size() == 0 && map.begin() == map.end());
+    map.reserve(range);
+    map[7] = 1;
+    CHECK(map.size() == 1 && map.at(7) == 1);
+}
+
+template<typename Probe, typename Hasher = std::hash<uint64_t>>
+using Map = hash_map<uint64_t, uint64_t, Hasher, std::equal_to<uint64_t>, Probe>;
+
+int main() {
+    Test::run("group_probe", [] {
+        differential<Map<group_probe>>(1, 4096, 200000);
+        differential<Map<group_probe>>(2, 64, 50000);
+    });
+    Test::run("group_probe colliding", [] {
+        differential<Map<group_probe, Colliding>>(3, 2048, 100000);
+    });
+    Test::run("double_hash_probe", [] {
+        differential<Map<double_hash_probe>>(4, 4096, 20000);
+    });
+
+    return Test::finish();
+}
@@ -0,0 +1,144 @@
+#include "../ecs.h"
+#include "test.h"
+
+#include <vector>
+#include <tuple>
+#include <algorithm>
+
+using namespace Byte;
+
+struct Position {
+    float x{}, y{};
+};
+
+struct Velocity {
+    float x{}, y{};
+};
+
+struct Frozen {};
+
+template<>
+inline constexpr bool Byte::TRACK_CHANGES<Position> = true;
+
+using Visits = std::vector<std::tuple<uint64_t, float, float>>;
+
+// each() and range-for must agree on which rows they visit and in what order.
+template<typename ViewType>
+void compare(ViewType view, size_t expected) {
+    Visits iterated;
+    for (auto [id, position, velocity] : view) {
+        iterated.emplace_back(id.id, position.x, velocity.y);
+    }
+
+    Visits visited;
+    view.each([&](EntityID id, Position& position, Velocity& velocity) {
+        visited.emplace_back(id.id, position.x, velocity.y);
+    });
+
+    Visits components;
+    view.each([&](EntityID& id, Position& position, Velocity& velocity) {
+        components.emplace_back(id.id, position.x, velocity.y);
+    });
+
+    CHECK(iterated.size() == expected);
+    CHECK(visited == iterated);
+    CHECK(components == iterated);
+}
+
+World populate(std::vector<EntityID>& ids) {
+    World world;
+    for (int i{}; i < 10000; ++i) {
+        switch (i % 4) {
+        case 0: ids.push_back(world.create(Position{ float(i), 0 }, Velocity{ 0, float(i) })); break;
+        case 1: ids.push_back(world.create(Position{ float(i), 0 }, Velocity{ 0, float(i) }, Frozen{})); break;
+        case 2: ids.push_back(world.create(Position{ float(i), 0 })); break;
+        default: ids.push_back(world.create(Position{ float(i), 0 }, Velocity{ 0, float(i) }, 1)); break;
+        }
+    }
+    return world;
+}
+
+void plain() {
+    std::vector<EntityID> ids;
+    World world{ populate(ids) };
+
+    compare(world.components<EntityID, Position, Velocity>(), 7500);
+    compare(world.components<EntityID, Position, Velocity>().exclude<Frozen>(), 5000);
+    compare(world.components<EntityID, Position, Velocity>().include<Frozen>(), 2500);
+}
+
+void erased() {
+    std::vector<EntityID> ids;
+    World world{ populate(ids) };
+
+    size_t remaining{};
+    for (size_t i{}; i < ids.size(); ++i) {
+        if (i % 3 == 0) {
+            world.destroy(ids[i]);
+        }
+        else {
+            remaining += i % 4 != 2;
+        }
+    }
+    compare(world.components<EntityID, Position, Velocity>(), remaining);
+}
+
+void filtered() {
+    std::vector<EntityID> ids;
+    World world{ populate(ids) };
+
+    Tick since{ world.advance() };
+    world.advance();
+    for (size_t i{}; i < ids.size(); i += 7) {
+        world.get<Position>(ids[i]).y = 1;
+    }
+
+    size_t changed{};
+    for (size_t i{}; i < ids.size(); i += 7) {
+        changed += i % 4 != 2;
+    }
+    compare(world.components<EntityID, Position, Velocity>().filter<Changed<Position>>(since), changed);
+}
+
+// Tag parameters are handed a local object per visit; they must not change which rows a view visits.
+void tagged() {
+    std::vector<EntityID> ids;
+    World world{ populate(ids) };
+
+    size_t visited{};
+    world.components<EntityID, Position, Frozen>().each([&](EntityID id, Position& position, Frozen&) {
+        visited += world.has<Frozen>(id) && position.y == 0;
+    });
+    CHECK(visited == 2500);
+
+    size_t iterated{};
+    for (auto [frozen, velocity] : world.components<const Frozen, const Velocity>()) {
+        iterated += velocity.y >= 0;
+    }
+    CHECK(iterated == 2500);
+
+    size_t gathered{};
+    world.gather<Frozen, const Velocity>(ids, [&](Frozen&, const Velocity&) {
+        ++gathered;
+    });
+    CHECK(gathered == 2500);
+}
+
+void empty() {
+    World world;
+    compare(world.components<EntityID, Position, Velocity>(), 0);
+
+    auto id{ world.create(Position{}, Velocity{}) };
+    world.destroy(id);
+    compare(world.components<EntityID, Position, Velocity>(), 0);
+}
+
+int main() {
+    Test::run("plain", plain);
+    Test::run("erased", erased);
+    Test::run("filtered", filtered);
+    Test::run("tagged", tagged);
+    Test::run("empty", empty);
+
+    return Test::finish();
+}
@@ -0,0 +1,94 @@
+#include "../ecs.h"
+#include "test.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <string>
+
+using namespace Byte;
+
+struct Position {
+    float x{}, y{};
+};
+
+struct Velocity {
+    float x{}, y{};
+};
+
+struct Marker {
+    int value{};
+};
+
+template<>
+inline constexpr bool Byte::SPARSE_STORAGE<Marker> = true;
+
+// Installed as the default resource, so anything that ignores the world's resource shows up here.
+counting_resource stray{ std::pmr::new_delete_resource() };
+
+// Whatever path fills a PmrWorld, its storage comes from the resource it was given.
+void commandBuffer() {
+    counting_resource direct{ std::pmr::new_delete_resource() };
+    counting_resource buffered{ std::pmr::new_delete_resource() };
+    {
+        PmrWorld world{ &direct };
+        for (int i{}; i < 20000; ++i) {
+            world.create(Position{ float(i) }, Velocity{});
+        }
+
+        PmrWorld target{ &buffered };
+        CommandBuffer<PmrWorld> buffer{ target };
+        for (int i{}; i < 20000; ++i) {
+            buffer.create(Position{ float(i) }, Velocity{});
+        }
+
+        size_t before{ stray.bytes() };
+        target.apply(buffer);
+        CHECK(stray.bytes() == before);
+        CHECK(target.size() == 20000);
+        CHECK(buffered.bytes() >= direct.bytes());
+    }
+    CHECK(direct.bytes() == 0);
+    CHECK(buffered.bytes() == 0);
+}
+
+void sparse() {
+    counting_resource resource{ std::pmr::new_delete_resource() };
+    {
+        PmrWorld world{ &resource };
+        size_t before{ stray.bytes() };
+
+        for (int i{}; i < 5000; ++i) {
+            EntityID id{ world.create(Position{ float(i) }) };
+            world.attach(id, Marker{ i });
+        }
+
+        CommandBuffer<PmrWorld> buffer{ world };
+        for (int i{}; i < 1000; ++i) {
+            buffer.create(Marker{ i });
+        }
+        world.apply(buffer);
+
+        PmrWorld fork{ world.fork() };
+        PmrWorld copy{ world.copy() };
+        CHECK(fork.size() == 6000 && copy.size() == 6000);
+
+        PmrWorld::serializable<Position, Marker>();
+        std::string path{ (std::filesystem::temp_directory_path() / "byte_ecs_memory.bin").string() };
+        world.save(path);
+        PmrWorld loaded{ PmrWorld::load(path, &resource) };
+        std::remove(path.c_str());
+        CHECK(loaded.size() == 6000);
+
+        CHECK(stray.bytes() == before);
+    }
+    CHECK(resource.bytes() == 0);
+}
+
+int main() {
+    std::pmr::set_default_resource(&stray);
+
+    Test::run("commandBuffer", commandBuffer);
+    Test::run("sparse", sparse);
+
+    return Test::finish();
+}
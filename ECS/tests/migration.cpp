@@ -0,0 +1,184 @@
+#include "../ecs.h"
+#include "test.h"
+
+#include <vector>
+
+using namespace Byte;
+
+struct Position {
+    float x{}, y{};
+};
+
+struct Velocity {
+    float x{}, y{};
+};
+
+struct Frozen {};
+
+struct Health {
+    int value{};
+};
+
+template<>
+inline constexpr bool Byte::TRACK_CHANGES<Health> = true;
+
+template<typename WorldType>
+void reattach() {
+    WorldType world;
+    auto a{ world.create(Position{ 1, 1 }, Velocity{ 1, 1 }) };
+    auto b{ world.create(Position{ 2, 2 }, Velocity{ 2, 2 }) };
+
+    world.attach(a, Velocity{ 5, 5 });
+    CHECK(world.template get<Velocity>(a).x == 5);
+
+    // Re-attaching must leave the archetype's detach edge intact.
+    world.template detach<Velocity>(b);
+    CHECK(!world.template has<Velocity>(b));
+    CHECK(world.template get<Position>(b).x == 2);
+    CHECK(world.template get<Position>(a).x == 1);
+    CHECK(world.template get<Velocity>(a).x == 5);
+
+    // Some components present, some new.
+    world.attach(a, Velocity{ 7, 7 }, Frozen{});
+    CHECK(world.template get<Velocity>(a).x == 7);
+    CHECK(world.template has<Frozen>(a));
+    CHECK(world.template get<Position>(a).x == 1);
+
+    world.template detach<Velocity>(a);
+    CHECK(!world.template has<Velocity>(a));
+    CHECK(world.template get<Position>(a).x == 1);
+}
+
+template<typename WorldType>
+void reattachMany() {
+    WorldType world;
+    std::vector<typename WorldType::EntityID> ids;
+    for (int i{}; i < 64; ++i) {
+        ids.push_back(world.create(Position{ float(i), 0 }, Velocity{ 0, float(i) }));
+    }
+
+    std::vector<typename WorldType::EntityID> half(ids.begin(), ids.begin() + 32);
+    world.attachMany(std::span<const typename WorldType::EntityID>{ half }, Velocity{ 9, 9 });
+    for (int i{}; i < 64; ++i) {
+        CHECK(world.template get<Velocity>(ids[i]).x == (i < 32 ? 9 : 0));
+        CHECK(world.template get<Position>(ids[i]).x == float(i));
+    }
+
+    world.template detach<Velocity>(ids[40]);
+    CHECK(!world.template has<Velocity>(ids[40]));
+    CHECK(world.template get<Position>(ids[40]).x == 40);
+
+    auto view{ world.template components<Position, Velocity>() };
+    world.attachMany(view, Velocity{ 3, 3 });
+    for (int i{}; i < 64; ++i) {
+        CHECK(world.template has<Velocity>(ids[i]) == (i != 40));
+    }
+
+    world.template detachMany<Velocity>(std::span<const typename WorldType::EntityID>{ half });
+    for (int i{}; i < 64; ++i) {
+        CHECK(world.template has<Velocity>(ids[i]) == (i >= 32 && i != 40));
+        CHECK(world.template get<Position>(ids[i]).x == float(i));
+    }
+}
+
+template<typename WorldType>
+void mixedArchetypes() {
+    WorldType world;
+    std::vector<typename WorldType::EntityID> ids;
+    for (int i{}; i < 30; ++i) {
+        ids.push_back(i % 3 == 0 ? world.create(Position{ float(i), 0 })
+            : i % 3 == 1 ? world.create(Position{ float(i), 0 }, Velocity{ 1, 1 })
+            : world.create(Position{ float(i), 0 }, Frozen{}));
+    }
+
+    world.attachMany(std::span<const typename WorldType::EntityID>{ ids }, Velocity{ 2, 2 });
+    for (int i{}; i < 30; ++i) {
+        CHECK(world.template get<Velocity>(ids[i]).x == 2);
+        CHECK(world.template get<Position>(ids[i]).x == float(i));
+        CHECK(world.template has<Frozen>(ids[i]) == (i % 3 == 2));
+    }
+
+    world.template detachMany<Velocity>(std::span<const typename WorldType::EntityID>{ ids });
+    for (int i{}; i < 30; ++i) {
+        CHECK(!world.template has<Velocity>(ids[i]));
+        CHECK(world.template get<Position>(ids[i]).x == float(i));
+    }
+}
+
+template<typename WorldType>
+void detachMissing() {
+    WorldType world;
+    auto a{ world.create(Position{ 1, 1 }) };
+    auto b{ world.create(Position{ 2, 2 }) };
+    auto empty{ world.create() };
+
+    // Detaching a component the entity lacks is a no-op and must not leave an edge from the archetype to itself.
+    world.template detach<Velocity>(a);
+    world.template detach<Velocity>(empty);
+    CHECK(world.template has<Position>(a) && !world.template has<Velocity>(a));
+    CHECK(world.template get<Position>(a).x == 1);
+
+    world.attach(b, Velocity{ 3, 3 });
+    CHECK(world.template get<Velocity>(b).x == 3);
+    CHECK(world.template get<Position>(b).x == 2);
+
+    world.attach(a, Velocity{ 4, 4 });
+    CHECK(world.template get<Velocity>(a).x == 4);
+    world.template detach<Velocity>(a);
+    CHECK(!world.template has<Velocity>(a));
+    CHECK(world.template has<Velocity>(b));
+}
+
+// attachMany/detachMany over a filtered view touch only the rows the filter passes.
+template<typename WorldType>
+void filteredView() {
+    WorldType world;
+    std::vector<typename WorldType::EntityID> ids;
+    for (int i{}; i < 20; ++i) {
+        ids.push_back(world.create(Health{ i }, Position{ float(i), 0 }));
+    }
+
+    Tick since{ world.advance() };
+    world.advance();
+    world.template get<Health>(ids[3]).value = 100;
+    world.template get<Health>(ids[11]).value = 100;
+
+    auto changed{ world.template components<Health>().template filter<Changed<Health>>(since) };
+    CHECK(changed.entities().size() == 2);
+
+    world.attachMany(changed, Velocity{ 9, 9 });
+    for (int i{}; i < 20; ++i) {
+        CHECK(world.template has<Velocity>(ids[i]) == (i == 3 || i == 11));
+        CHECK(world.template get<Position>(ids[i]).x == float(i));
+    }
+
+    // Attaching again to a row that already has the component assigns only that row.
+    since = world.advance();
+    world.advance();
+    world.template get<Health>(ids[3]).value = 200;
+    auto again{ world.template components<Health>().template filter<Changed<Health>>(since) };
+    world.attachMany(again, Velocity{ 1, 1 });
+    CHECK(world.template get<Velocity>(ids[3]).x == 1);
+    CHECK(world.template get<Velocity>(ids[11]).x == 9);
+
+    world.template detachMany<Velocity>(again);
+    CHECK(!world.template has<Velocity>(ids[3]));
+    CHECK(world.template has<Velocity>(ids[11]));
+    CHECK(world.template get<Health>(ids[11]).value == 100);
+}
+
+int main() {
+    Test::run("reattach", reattach<World>);
+    Test::run("reattach dense", reattach<DenseWorld>);
+    Test::run("reattach chunked", reattach<ChunkedWorld>);
+    Test::run("reattachMany", reattachMany<World>);
+    Test::run("reattachMany dense", reattachMany<DenseWorld>);
+    Test::run("reattachMany chunked", reattachMany<ChunkedWorld>);
+    Test::run("mixedArchetypes", mixedArchetypes<World>);
+    Test::run("mixedArchetypes dense", mixedArchetypes<DenseWorld>);
+    Test::run("detachMissing", detachMissing<World>);
+    Test::run("detachMissing dense", detachMissing<DenseWorld>);
+    Test::run("filteredView", filteredView<World>);
+
+    return Test::finish();
+}
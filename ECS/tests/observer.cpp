@@ -0,0 +1,181 @@
+#include "../ecs.h"
+#include "test.h"
+
+#include <vector>
+#include <algorithm>
+
+using namespace Byte;
+
+struct Position {
+    float x{}, y{};
+};
+
+struct Velocity {
+    float x{}, y{};
+};
+
+struct Frozen {};
+
+template<typename EntityID>
+bool contains(const std::vector<EntityID>& ids, EntityID id) {
+    return std::find(ids.begin(), ids.end(), id) != ids.end();
+}
+
+// Every change between two flushes is delivered as one span per component and event.
+template<typename WorldType>
+void batched() {
+    using EntityID = typename WorldType::EntityID;
+
+    WorldType world;
+    size_t addCalls{}, removeCalls{}, destroyCalls{};
+    std::vector<EntityID> added, removed, destroyed;
+
+    world.template onAdd<Velocity>([&](std::span<const EntityID> ids) {
+        ++addCalls;
+        added.insert(added.end(), ids.begin(), ids.end());
+    });
+    world.template onRemove<Velocity>([&](std::span<const EntityID> ids) {
+        ++removeCalls;
+        removed.insert(removed.end(), ids.begin(), ids.end());
+    });
+    world.template onDestroy<Position>([&](std::span<const EntityID> ids) {
+        ++destroyCalls;
+        destroyed.insert(destroyed.end(), ids.begin(), ids.end());
+    });
+
+    std::vector<EntityID> ids;
+    for (int i{}; i < 16; ++i) {
+        ids.push_back(world.create(Position{ float(i), 0 }));
+    }
+    for (EntityID id : ids) {
+        world.attach(id, Velocity{ 1, 1 });
+    }
+
+    // Nothing is delivered until flush.
+    CHECK(addCalls == 0);
+    world.flush();
+    CHECK(addCalls == 1);
+    CHECK(added.size() == ids.size());
+    for (EntityID id : ids) {
+        CHECK(contains(added, id));
+    }
+
+    // Attaching an unrelated component does not report Velocity again.
+    world.attach(ids[0], Frozen{});
+    world.template detach<Velocity>(ids[1]);
+    world.template detach<Velocity>(ids[2]);
+    world.destroy(ids[3]);
+    world.destroy(ids[4]);
+    world.flush();
+    CHECK(addCalls == 1);
+    CHECK(removeCalls == 1);
+    CHECK(removed.size() == 2);
+    CHECK(contains(removed, ids[1]) && contains(removed, ids[2]));
+    CHECK(destroyCalls == 1);
+    CHECK(destroyed.size() == 2);
+    CHECK(contains(destroyed, ids[3]) && contains(destroyed, ids[4]));
+
+    // An empty flush delivers nothing.
+    world.flush();
+    CHECK(addCalls == 1 && removeCalls == 1 && destroyCalls == 1);
+}
+
+// Events raised by observers are delivered by the same flush.
+template<typename WorldType>
+void cascade() {
+    using EntityID = typename WorldType::EntityID;
+
+    WorldType world;
+    size_t frozen{}, removed{};
+
+    // Moving entities get frozen, frozen entities lose their velocity.
+    world.template onAdd<Velocity>([&](std::span<const EntityID> ids) {
+        std::vector<EntityID> copy(ids.begin(), ids.end());
+        for (EntityID id : copy) {
+            world.attach(id, Frozen{});
+        }
+    });
+    world.template onAdd<Frozen>([&](std::span<const EntityID> ids) {
+        frozen += ids.size();
+        std::vector<EntityID> copy(ids.begin(), ids.end());
+        for (EntityID id : copy) {
+            world.template detach<Velocity>(id);
+        }
+    });
+    world.template onRemove<Velocity>([&](std::span<const EntityID> ids) {
+        removed += ids.size();
+    });
+
+    std::vector<EntityID> ids;
+    for (int i{}; i < 8; ++i) {
+        ids.push_back(world.create(Position{}, Velocity{}));
+    }
+    world.flush();
+
+    CHECK(frozen == 8);
+    CHECK(removed == 8);
+    for (EntityID id : ids) {
+        CHECK(world.template has<Frozen>(id));
+        CHECK(!world.template has<Velocity>(id));
+    }
+
+    world.flush();
+    CHECK(frozen == 8 && removed == 8);
+}
+
+// Observers registered from inside an observer take effect from the next round of the same flush.
+template<typename WorldType>
+void registering() {
+    using EntityID = typename WorldType::EntityID;
+
+    WorldType world;
+    size_t registered{}, velocities{}, positions{}, late{};
+
+    world.template onAdd<Position>([&](std::span<const EntityID> ids) {
+        positions += ids.size();
+        if (registered++) {
+            return;
+        }
+
+        // Enough registrations on the running event to force its observer list to grow.
+        for (int i{}; i < 32; ++i) {
+            world.template onAdd<Position>([&](std::span<const EntityID> ids) {
+                late += ids.size();
+            });
+        }
+        world.template onAdd<Velocity>([&](std::span<const EntityID> ids) {
+            velocities += ids.size();
+        });
+
+        std::vector<EntityID> copy(ids.begin(), ids.end());
+        for (EntityID id : copy) {
+            world.attach(id, Velocity{});
+        }
+    });
+
+    for (int i{}; i < 4; ++i) {
+        world.create(Position{});
+    }
+    world.flush();
+
+    // The batch that registered them is not replayed to the new observers.
+    CHECK(positions == 4);
+    CHECK(late == 0);
+    CHECK(velocities == 4);
+
+    world.create(Position{});
+    world.flush();
+    CHECK(positions == 5);
+    CHECK(late == 32);
+    CHECK(velocities == 4);
+}
+
+int main() {
+    Test::run("batched", batched<World>);
+    Test::run("batched dense", batched<DenseWorld>);
+    Test::run("cascade", cascade<World>);
+    Test::run("cascade dense", cascade<DenseWorld>);
+    Test::run("registering", registering<World>);
+    Test::run("registering dense", registering<DenseWorld>);
+    return Test::finish();
+}
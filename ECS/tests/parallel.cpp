@@ -0,0 +1,133 @@
+#include "../ecs.h"
+#include "test.h"
+
+#include <vector>
+#include <atomic>
+#include <memory>
+
+using namespace Byte;
+
+struct Slot {
+    size_t value{};
+};
+
+struct Velocity {
+    float x{}, y{};
+};
+
+struct Frozen {};
+
+template<>
+inline constexpr bool Byte::TRACK_CHANGES<Velocity> = true;
+
+using Hits = std::vector<std::atomic<uint32_t>>;
+
+// Uneven archetype sizes, so grains straddle archetype boundaries at different offsets.
+World populate(size_t count) {
+    World world;
+    for (size_t i{}; i < count; ++i) {
+        switch (i % 5) {
+        case 0: world.create(Slot{ i }); break;
+        case 1: world.create(Slot{ i }, Velocity{}); break;
+        case 2: world.create(Slot{ i }, Velocity{}, Frozen{}); break;
+        case 3: world.create(Slot{ i }, 1); break;
+        default: world.create(Slot{ i }, Velocity{}, 1); break;
+        }
+    }
+    return world;
+}
+
+template<typename ViewType>
+void once(ViewType view, size_t count, size_t expected, size_t grain) {
+    Hits hits(count);
+    view.parallelEach([&hits](Slot& slot) {
+        hits[slot.value].fetch_add(1, std::memory_order_relaxed);
+    }, grain);
+
+    size_t visited{};
+    size_t repeated{};
+    for (const std::atomic<uint32_t>& hit : hits) {
+        visited += hit.load() != 0;
+        repeated += hit.load() > 1;
+    }
+    CHECK(visited == expected);
+    CHECK(repeated == 0);
+
+    // The same rows each() sees.
+    size_t matching{};
+    view.each([&](Slot& slot) {
+        matching += hits[slot.value].load() == 1;
+    });
+    CHECK(matching == expected);
+}
+
+void grains() {
+    constexpr size_t COUNT{ 20011 };
+    World world{ populate(COUNT) };
+
+    for (size_t threads : { size_t{ 1 }, size_t{ 4 } }) {
+        world.threadPool(std::make_shared<ThreadPool>(threads));
+        for (size_t grain : { size_t{ 0 }, size_t{ 1 }, size_t{ 7 }, size_t{ 64 }, size_t{ 4096 }, COUNT, size_t{ 1 } << 20 }) {
+            once(world.components<Slot>(), COUNT, COUNT, grain);
+            once(world.components<Slot>().include<Velocity>(), COUNT, COUNT * 3 / 5, grain);
+            once(world.components<Slot>().exclude<Frozen>(), COUNT, COUNT - COUNT / 5, grain);
+        }
+    }
+}
+
+void filtered() {
+    constexpr size_t COUNT{ 5000 };
+    World world{ populate(COUNT) };
+
+    Tick since{ world.advance() };
+    world.advance();
+
+    // A mutable view marks every row it visits, so only these rows are written through get().
+    std::vector<EntityID> ids;
+    world.components<const Slot, const Velocity>().each([&](EntityID id, const Slot& slot, const Velocity&) {
+        if (slot.value % 3 == 0) {
+            ids.push_back(id);
+        }
+    });
+    for (EntityID id : ids) {
+        world.get<Velocity>(id).x = 1;
+    }
+    size_t changed{ ids.size() };
+
+    world.threadPool(std::make_shared<ThreadPool>(4));
+    for (size_t grain : { size_t{ 1 }, size_t{ 13 }, size_t{ 4096 } }) {
+        once(world.components<Slot>().filter<Changed<Velocity>>(since), COUNT, changed, grain);
+    }
+}
+
+void empty() {
+    World world;
+    once(world.components<Slot>(), 1, 0, 64);
+
+    auto id{ world.create(Slot{}) };
+    world.destroy(id);
+    once(world.components<Slot>(), 1, 0, 64);
+}
+
+// Tasks submitted from workers land on the submitter's own queue and can be taken the moment they are queued.
+void nested() {
+    ThreadPool pool{ 4 };
+    std::atomic<size_t> leaves{};
+    for (size_t round{}; round < 50; ++round) {
+        pool.run(8, [&](size_t) {
+            pool.run(16, [&](size_t) {
+                leaves.fetch_add(1, std::memory_order_relaxed);
+            });
+        });
+    }
+    CHECK(leaves.load() == 50 * 8 * 16);
+}
+
+int main() {
+    Test::run("grains", grains);
+    Test::run("filtered", filtered);
+    Test::run("empty", empty);
+    Test::run("nested", nested);
+
+    return Test::finish();
+}
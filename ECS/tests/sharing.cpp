@@ -0,0 +1,108 @@
+#include "../ecs.h"
+#include "test.h"
+
+#include <memory>
+#include <vector>
+#include <utility>
+#include <algorithm>
+
+using namespace Byte;
+
+struct Position {
+    float x{}, y{};
+};
+
+struct Velocity {
+    float x{ 1.0f }, y{ 2.0f };
+};
+
+// The storage behind one component in every archetype that has it, sorted so that worlds can be compared.
+template<typename Component>
+std::vector<const void*> columns(World& world) {
+    std::vector<World::Archetype*> arches{ world.components<const Component>().archetypes() };
+    std::vector<const void*> out;
+    for (World::Archetype* arche : arches) {
+        out.push_back(std::as_const(*arche).columnAccessor(Registry<Component>::id()));
+    }
+    std::sort(out.begin(), out.end());
+    return out;
+}
+
+World populate() {
+    World world;
+    for (int i{}; i < 100000; ++i) {
+        if (i % 3) {
+            world.create(Position{ float(i) }, Velocity{});
+        }
+        else {
+            world.create(Position{ float(i) }, Velocity{}, i);
+        }
+    }
+    return world;
+}
+
+// Reading a fork through const components leaves its columns shared with the original.
+void readOnly() {
+    World world{ populate() };
+    World fork{ world.fork() };
+    CHECK(columns<Position>(fork) == columns<Position>(world));
+
+    float sum{};
+    fork.components<const Position>().each([&](const Position& position) {
+        sum += position.x;
+    });
+    for (auto [position, velocity] : fork.components<const Position, const Velocity>()) {
+        sum += position.x + velocity.y;
+    }
+    fork.components<const Position>().eachChunk([&](std::span<const Position> positions) {
+        sum += positions.front().x;
+    });
+
+    std::vector<EntityID> ids;
+    fork.components<EntityID>().each([&](EntityID id) {
+        ids.push_back(id);
+    });
+    fork.gather<const Position, const Velocity>(ids, [&](const Position& position, const Velocity&) {
+        sum += position.x;
+    });
+
+    fork.threadPool(std::make_shared<ThreadPool>(2));
+    fork.components<const Position, Velocity>().parallelEach([](const Position& position, Velocity& velocity) {
+        velocity.x = position.x;
+    }, 1024);
+
+    CHECK(sum > 0.0f);
+    CHECK(columns<Position>(fork) == columns<Position>(world));
+    CHECK(columns<Velocity>(fork) != columns<Velocity>(world));
+}
+
+// Writing through a fork unshares only the written column and leaves the original untouched.
+void written() {
+    World world{ populate() };
+    World fork{ world.fork() };
+
+    fork.components<Position, const Velocity>().each([](Position& position, const Velocity& velocity) {
+        position.y = velocity.y;
+    });
+
+    CHECK(columns<Velocity>(fork) == columns<Velocity>(world));
+    CHECK(columns<Position>(fork) != columns<Position>(world));
+
+    size_t original{};
+    world.components<const Position>().each([&](const Position& position) {
+        original += position.y == 0.0f;
+    });
+    size_t forked{};
+    fork.components<const Position>().each([&](const Position& position) {
+        forked += position.y == 2.0f;
+    });
+    CHECK(original == 100000);
+    CHECK(forked == 100000);
+}
+
+int main() {
+    Test::run("readOnly", readOnly);
+    Test::run("written", written);
+
+    return Test::finish();
+}
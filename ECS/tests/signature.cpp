@@ -0,0 +1,112 @@
+#include "../ecs.h"
+#include "test.h"
+
+#include <bitset>
+#include <random>
+#include <vector>
+#include <utility>
+
+using namespace Byte;
+
+using Sig = World::Signature;
+using Reference = std::bitset<World::MAX_COMPONENT_COUNT>;
+
+template<size_t N>
+struct Field {
+    int value{};
+};
+
+// Sparse random bit patterns, with ids drawn from both the low and the high words.
+std::pair<Sig, Reference> random(std::mt19937_64& engine) {
+    Sig signature;
+    Reference reference;
+    size_t count{ engine() % 12 };
+    for (size_t bit{}; bit < count; ++bit) {
+        ComponentID id{ static_cast<ComponentID>(engine() % 2 ? engine() % 16 : engine() % World::MAX_COMPONENT_COUNT) };
+        signature.set(id);
+        reference.set(id);
+    }
+    return { signature, reference };
+}
+
+void differential() {
+    std::mt19937_64 engine{ 11 };
+    std::vector<std::pair<Sig, Reference>> signatures;
+    for (size_t i{}; i < 512; ++i) {
+        signatures.push_back(random(engine));
+    }
+
+    for (const auto& [left, leftBits] : signatures) {
+        CHECK(left.count() == leftBits.count());
+        CHECK(left.any() == leftBits.any());
+
+        Reference visited;
+        left.each([&](ComponentID id) {
+            visited.set(id);
+        });
+        CHECK(visited == leftBits);
+
+        for (const auto& [right, rightBits] : signatures) {
+            CHECK(left.includes(right) == ((rightBits & ~leftBits).none()));
+            CHECK(left.matches(right) == ((leftBits & rightBits).any()));
+            CHECK((left == right) == (leftBits == rightBits));
+        }
+    }
+
+    Sig signature;
+    signature.set(700);
+    signature.set(700, false);
+    CHECK(!signature.any());
+    CHECK(Sig{}.includes(Sig{}));
+}
+
+template<size_t... Indices>
+void createMasked(World& world, size_t mask, std::index_sequence<Indices...>) {
+    EntityID id{ world.create(Field<0>{ int(mask) }) };
+    ((mask >> Indices & 1 ? world.attach(id, Field<Indices + 1>{}) : void()), ...);
+}
+
+template<size_t... Indices>
+size_t viewCount(World& world, std::index_sequence<Indices...>) {
+    size_t out{};
+    world.components<const Field<0>, const Field<Indices + 1>...>().each([&](const Field<0>&, const Field<Indices + 1>&...) {
+        ++out;
+    });
+    return out;
+}
+
+// Views resolved through the component index see exactly the entities a brute-force mask check does.
+void componentIndex() {
+    constexpr size_t TYPES{ 8 };
+    World world;
+    for (size_t mask{}; mask < (size_t{ 1 } << TYPES); ++mask) {
+        createMasked(world, mask, std::make_index_sequence<TYPES>{});
+        createMasked(world, mask, std::make_index_sequence<TYPES>{});
+    }
+
+    auto expected{ [](size_t required) {
+        size_t out{};
+        for (size_t mask{}; mask < (size_t{ 1 } << TYPES); ++mask) {
+            out += (mask & required) == required ? 2 : 0;
+        }
+        return out;
+    } };
+
+    CHECK(viewCount(world, std::index_sequence<>{}) == expected(0));
+    CHECK(viewCount(world, std::index_sequence<0>{}) == expected(0b1));
+    CHECK(viewCount(world, std::index_sequence<2, 5>{}) == expected(0b100100));
+    CHECK(viewCount(world, std::index_sequence<0, 1, 2, 3, 4, 5, 6, 7>{}) == expected(0xFF));
+
+    size_t excluded{};
+    world.components<const Field<0>, const Field<3>>().exclude<Field<6>>().each([&](const Field<0>&, const Field<3>&) {
+        ++excluded;
+    });
+    CHECK(excluded == expected(0b1000) - expected(0b1001000));
+}
+
+int main() {
+    Test::run("differential", differential);
+    Test::run("componentIndex", componentIndex);
+
+    return Test::finish();
+}
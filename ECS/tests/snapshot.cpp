@@ -0,0 +1,215 @@
+#include "../ecs.h"
+#include "test.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+using namespace Byte;
+
+struct Position {
+    float x{}, y{};
+};
+
+struct Health {
+    int value{};
+};
+
+struct Marker {
+    int value{};
+};
+
+template<>
+inline constexpr bool Byte::SPARSE_STORAGE<Marker> = true;
+
+std::string temporary(const char* name) {
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+// Every entity, archetype row, sparse component and entity without components survives save() and load().
+void roundTrip() {
+    World::serializable<Position, Health, Marker>();
+
+    World world;
+    std::vector<EntityID> ids;
+    for (int i{}; i < 5000; ++i) {
+        switch (i % 3) {
+        case 0: ids.push_back(world.create(Position{ float(i), -float(i) })); break;
+        case 1: ids.push_back(world.create(Position{ float(i), -float(i) }, Health{ i })); break;
+        default: ids.push_back(world.create()); break;
+        }
+        if (i % 5 == 0) {
+            world.attach(ids.back(), Marker{ i });
+        }
+    }
+    for (size_t i{}; i < ids.size(); i += 11) {
+        world.destroy(ids[i]);
+    }
+    world.advance();
+
+    std::string path{ temporary("byte_ecs_roundtrip.bin") };
+    world.save(path);
+    World loaded{ World::load(path) };
+    std::remove(path.c_str());
+
+    CHECK(loaded.size() == world.size());
+    for (size_t i{}; i < ids.size(); ++i) {
+        if (i % 11 == 0) {
+            continue;
+        }
+
+        EntityID id{ ids[i] };
+        CHECK(loaded.has<Position>(id) == world.has<Position>(id));
+        CHECK(loaded.has<Health>(id) == world.has<Health>(id));
+        CHECK(loaded.has<Marker>(id) == world.has<Marker>(id));
+
+        if (world.has<Position>(id)) {
+            CHECK(loaded.get<Position>(id).x == world.get<Position>(id).x);
+            CHECK(loaded.get<Position>(id).y == world.get<Position>(id).y);
+        }
+        if (world.has<Health>(id)) {
+            CHECK(loaded.get<Health>(id).value == world.get<Health>(id).value);
+        }
+        if (world.has<Marker>(id)) {
+            CHECK(loaded.get<Marker>(id).value == world.get<Marker>(id).value);
+        }
+    }
+
+    size_t expected{};
+    world.components<const Health>().each([&](const Health&) {
+        ++expected;
+    });
+    size_t visited{};
+    loaded.components<const Position, const Health>().each([&](const Position& position, const Health& health) {
+        visited += position.x == float(health.value);
+    });
+    CHECK(visited == expected);
+
+    // The loaded world is independent and fully usable.
+    EntityID created{ loaded.create(Position{ 1.0f, 2.0f }, Health{ 3 }) };
+    CHECK(loaded.get<Health>(created).value == 3);
+    CHECK(loaded.size() == world.size() + 1);
+}
+
+// patch() applied to a copy of base reproduces the world diff() was taken from, including deltas whose entity lists are empty.
+void delta() {
+    World world;
+    std::vector<EntityID> ids;
+    for (int i{}; i < 300; ++i) {
+        ids.push_back(i % 2 ? world.create(Position{ float(i) }) : world.create(Position{ float(i) }, Health{ i }));
+    }
+
+    World base{ world.copy() };
+    std::vector<std::byte> unchanged{ world.diff(base) };
+    World replica{ base.copy() };
+    replica.patch(unchanged);
+    CHECK(replica.size() == world.size());
+
+    // Emptying the Position+Health archetype leaves it behind with no rows.
+    for (int i{}; i < 300; i += 2) {
+        world.destroy(ids[i]);
+    }
+    for (int i{ 1 }; i < 300; i += 4) {
+        world.get<Position>(ids[i]).y = 7.0f;
+    }
+    world.advance();
+
+    std::vector<std::byte> changes{ world.diff(base) };
+    replica = base.copy();
+    replica.patch(changes);
+    CHECK(replica.size() == world.size());
+    for (int i{ 1 }; i < 300; i += 2) {
+        CHECK(replica.has<Position>(ids[i]) && !replica.has<Health>(ids[i]));
+        CHECK(replica.get<Position>(ids[i]).y == world.get<Position>(ids[i]).y);
+    }
+
+    World settled{ world.copy() };
+    std::vector<std::byte> empty{ world.diff(settled) };
+    settled.patch(empty);
+    CHECK(settled.size() == world.size());
+}
+
+// A dense world reloads rows out of index order, so load() fills slots the entity table first put on its free list.
+// Those slots must not be handed out again by create().
+void dense() {
+    DenseWorld::serializable<Position, Health>();
+
+    DenseWorld world;
+    DenseEntityID a{ world.create(Position{ 1.0f }) };
+    DenseEntityID b{ world.create(Position{ 2.0f }) };
+    DenseEntityID c{ world.create(Position{ 3.0f }) };
+    world.destroy(a);
+
+    std::string path{ temporary("byte_ecs_dense.bin") };
+    world.save(path);
+    DenseWorld loaded{ DenseWorld::load(path) };
+    std::remove(path.c_str());
+
+    CHECK(loaded.size() == 2);
+    DenseEntityID created{ loaded.create(Position{ 4.0f }) };
+    CHECK(created != b && created != c);
+    CHECK(loaded.size() == 3);
+    CHECK(loaded.get<Position>(b).x == 2.0f);
+    CHECK(loaded.get<Position>(c).x == 3.0f);
+    CHECK(loaded.get<Position>(created).x == 4.0f);
+
+    size_t rows{};
+    loaded.components<const Position>().each([&](const Position&) {
+        ++rows;
+    });
+    CHECK(rows == loaded.size());
+
+    // Every later id is distinct from the live ones as well.
+    std::vector<DenseEntityID> more;
+    for (int i{}; i < 100; ++i) {
+        more.push_back(loaded.create(Health{ i }));
+    }
+    for (DenseEntityID id : more) {
+        CHECK(id != b && id != c && id != created);
+        CHECK(loaded.has<Health>(id));
+    }
+    CHECK(loaded.size() == 103);
+
+    // patch() emplaces created entities by index as well.
+    DenseWorld base{ world.copy() };
+    DenseEntityID d{ world.create(Position{ 5.0f }) };
+    world.destroy(b);
+    DenseEntityID e{ world.create(Position{ 6.0f }) };
+    world.advance();
+
+    DenseWorld replica{ base.copy() };
+    replica.patch(world.diff(base));
+    CHECK(replica.size() == world.size());
+    DenseEntityID next{ replica.create(Position{ 7.0f }) };
+    CHECK(next != c && next != d && next != e);
+    CHECK(replica.size() == world.size() + 1);
+}
+
+void rejected() {
+    std::string path{ temporary("byte_ecs_rejected.bin") };
+    {
+        std::FILE* file{ std::fopen(path.c_str(), "wb") };
+        std::fputs("not a snapshot, just some bytes", file);
+        std::fclose(file);
+    }
+
+    bool thrown{ false };
+    try {
+        World::load(path);
+    }
+    catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    std::remove(path.c_str());
+    CHECK(thrown);
+}
+
+int main() {
+    Test::run("roundTrip", roundTrip);
+    Test::run("delta", delta);
+    Test::run("dense", dense);
+    Test::run("rejected", rejected);
+
+    return Test::finish();
+}
@@ -0,0 +1,175 @@
+#include "../ecs.h"
+#include "test.h"
+
+#include <vector>
+#include <algorithm>
+
+using namespace Byte;
+
+struct Position {
+    float x{}, y{};
+};
+
+struct Velocity {
+    float x{}, y{};
+};
+
+struct Frozen {};
+
+struct Marker {
+    int value{};
+};
+
+template<>
+inline constexpr bool Byte::SPARSE_STORAGE<Marker> = true;
+
+bool distinct(std::vector<DenseEntityID> ids) {
+    std::sort(ids.begin(), ids.end(), [](DenseEntityID left, DenseEntityID right) {
+        return static_cast<uint64_t>(left) < static_cast<uint64_t>(right);
+    });
+    return std::adjacent_find(ids.begin(), ids.end()) == ids.end();
+}
+
+// Prototypes are copied into every entity, callables receive the index within the batch.
+template<typename WorldType>
+void initializers() {
+    WorldType world;
+    auto existing{ world.create(Position{ -1, -1 }, Velocity{ 3, 3 }) };
+
+    auto ids{ Spawner<WorldType>::spawn(world, 100,
+        [](size_t index) { return Position{ float(index), 0 }; },
+        Velocity{ 3, 3 }) };
+
+    CHECK(ids.size() == 100);
+    CHECK(world.size() == 101);
+    for (size_t i{}; i < ids.size(); ++i) {
+        CHECK(world.template get<Position>(ids[i]).x == float(i));
+        CHECK(world.template get<Velocity>(ids[i]).x == 3);
+    }
+    CHECK(world.template get<Position>(existing).x == -1);
+
+    // Spawned entities migrate like any other.
+    world.template detach<Velocity>(ids[0]);
+    CHECK(world.template get<Position>(ids[99]).x == 99);
+    CHECK(world.template get<Position>(ids[0]).x == 0);
+}
+
+// Batches spanning several tasks fill every row exactly once.
+template<typename WorldType>
+void parallel() {
+    WorldType world;
+    size_t count{ Spawner<WorldType>::PARALLEL_GRAIN * 2 + 5 };
+
+    auto ids{ Spawner<WorldType>::parallelSpawn(world, count,
+        [](size_t index) { return Position{ float(index), float(index) * 2 }; },
+        [](size_t index) { return Velocity{ 0, float(index) }; }) };
+
+    CHECK(world.size() == count);
+    bool matched{ true };
+    for (size_t i{}; i < count; ++i) {
+        const Position& position{ world.template get<Position>(ids[i]) };
+        matched = matched && position.x == float(i) && position.y == float(i) * 2;
+        matched = matched && world.template get<Velocity>(ids[i]).y == float(i);
+    }
+    CHECK(matched);
+}
+
+// Batches of only sparse components create entities without an archetype.
+template<typename WorldType>
+void sparseOnly() {
+    WorldType world;
+    auto ids{ Spawner<WorldType>::spawn(world, 20, [](size_t index) { return Marker{ int(index) }; }) };
+
+    CHECK(world.size() == 20);
+    for (size_t i{}; i < ids.size(); ++i) {
+        CHECK(world.template get<Marker>(ids[i]).value == int(i));
+    }
+
+    world.attach(ids[5], Position{ 5, 5 });
+    CHECK(world.template get<Position>(ids[5]).x == 5);
+    CHECK(world.template get<Marker>(ids[5]).value == 5);
+
+    world.destroy(ids[6]);
+    CHECK(world.size() == 19);
+    CHECK(world.template get<Marker>(ids[7]).value == 7);
+}
+
+// Tags join the signature without a column; sparse components mixed in are attached per entity.
+template<typename WorldType>
+void tags() {
+    WorldType world;
+    auto ids{ Spawner<WorldType>::spawn(world, 10, Position{ 1, 1 }, Frozen{},
+        [](size_t index) { return Marker{ int(index) * 10 }; }) };
+
+    for (size_t i{}; i < ids.size(); ++i) {
+        CHECK(world.template has<Frozen>(ids[i]));
+        CHECK(world.template get<Position>(ids[i]).x == 1);
+        CHECK(world.template get<Marker>(ids[i]).value == int(i) * 10);
+    }
+
+    // The batch lands in the same archetype as a regular create.
+    auto created{ world.create(Position{ 2, 2 }, Frozen{}) };
+    size_t rows{};
+    world.template components<const Position, const Frozen>().each([&](const Position&, const Frozen&) {
+        ++rows;
+    });
+    CHECK(rows == 11);
+    CHECK(world.template get<Position>(created).x == 2);
+}
+
+// Slots freed by destroy are handed out again by the batch, with a new generation.
+void reuse() {
+    DenseWorld world;
+    std::vector<DenseEntityID> ids;
+    for (int i{}; i < 10; ++i) {
+        ids.push_back(world.create(Position{ float(i), 0 }));
+    }
+
+    std::vector<DenseEntityID> destroyed;
+    for (int i{ 1 }; i < 10; i += 2) {
+        destroyed.push_back(ids[i]);
+        world.destroy(ids[i]);
+    }
+
+    auto spawned{ Spawner<DenseWorld>::spawn(world, 8, Position{ 100, 0 }) };
+    CHECK(distinct(spawned));
+
+    size_t reused{};
+    for (DenseEntityID id : spawned) {
+        CHECK(std::find(destroyed.begin(), destroyed.end(), id) == destroyed.end());
+        CHECK(id.index < 13);
+        reused += id.index < 10;
+        CHECK(world.template get<Position>(id).x == 100);
+    }
+    CHECK(reused == destroyed.size());
+    CHECK(world.size() == 13);
+
+    for (int i{}; i < 10; i += 2) {
+        CHECK(world.template get<Position>(ids[i]).x == float(i));
+    }
+
+    // The free list is drained, so the next entity takes a fresh slot.
+    auto next{ world.create(Position{}) };
+    CHECK(next.index == 13);
+
+    std::vector<DenseEntityID> all{ spawned };
+    all.push_back(next);
+    for (int i{}; i < 10; i += 2) {
+        all.push_back(ids[i]);
+    }
+    CHECK(distinct(all));
+}
+
+int main() {
+    Test::run("initializers", initializers<World>);
+    Test::run("initializers dense", initializers<DenseWorld>);
+    Test::run("parallel", parallel<World>);
+    Test::run("parallel dense", parallel<DenseWorld>);
+    Test::run("sparseOnly", sparseOnly<World>);
+    Test::run("sparseOnly dense", sparseOnly<DenseWorld>);
+    Test::run("tags", tags<World>);
+    Test::run("tags dense", tags<DenseWorld>);
+    Test::run("reuse", reuse);
+
+    return Test::finish();
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <iostream>
+#include <exception>
+
+// Each file in tests/ is a standalone program that returns non-zero on failure, e.g.
+//   cl /std:c++20 /EHsc tests\migration.cpp
+//   g++ -std=c++20 -pthread tests/migration.cpp
+
+namespace Byte::Test {
+
+	inline size_t failures{};
+
+	inline void check(bool condition, const char* expression, const char* file, int line) {
+		if (!condition) {
+			++failures;
+			std::cerr << file << ':' << line << ": CHECK(" << expression << ") failed\n";
+		}
+	}
+
+	template<typename Function>
+	void run(const char* name, Function&& function) {
+		size_t before{ failures };
+		try {
+			function();
+		}
+		catch (const std::exception& exception) {
+			++failures;
+			std::cerr << name << ": threw " << exception.what() << '\n';
+		}
+		std::cout << (failures == before ? "pass " : "FAIL ") << name << '\n';
+	}
+
+	inline int finish() {
+		std::cout << (failures ? "failed\n" : "ok\n");
+		return failures ? 1 : 0;
+	}
+
+}
+
+#define CHECK(condition) ::Byte::Test::check(static_cast<bool>(condition), #condition, __FILE__, __LINE__)
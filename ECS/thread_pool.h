@@ -0,0 +1,184 @@
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <algorithm>
+
+namespace Byte {
+
+	class ThreadPool {
+	public:
+		using Task = std::function<void()>;
+
+	private:
+		struct Queue {
+			std::mutex mutex;
+			std::deque<Task> tasks;
+		};
+
+		using QueueVector = std::vector<std::unique_ptr<Queue>>;
+		using ThreadVector = std::vector<std::thread>;
+
+		QueueVector _queues;
+		ThreadVector _threads;
+
+		std::mutex _mutex;
+		std::condition_variable _condition;
+		std::atomic<size_t> _pending{ 0 };
+		std::atomic<size_t> _next{ 0 };
+		bool _stop{ false };
+
+		inline static thread_local ThreadPool* _owner{ nullptr };
+		inline static thread_local size_t _worker{ 0 };
+
+	public:
+		explicit ThreadPool(size_t threadCount = std::max<size_t>(1, std::thread::hardware_concurrency())) {
+			for (size_t _index{}; _index <= threadCount; ++_index) {
+				_queues.push_back(std::make_unique<Queue>());
+			}
+
+			for (size_t _index{ 1 }; _index <= threadCount; ++_index) {
+				_threads.emplace_back([this, _index]() {
+					work(_index);
+				});
+			}
+		}
+
+		ThreadPool(const ThreadPool&) = delete;
+
+		ThreadPool& operator=(const ThreadPool&) = delete;
+
+		~ThreadPool() {
+			{
+				std::lock_guard<std::mutex> lock{ _mutex };
+				_stop = true;
+			}
+			_condition.notify_all();
+
+			for (std::thread& thread : _threads) {
+				thread.join();
+			}
+		}
+
+		size_t size() const {
+			return _threads.size();
+		}
+
+		void submit(Task task) {
+			size_t queue{ _owner == this ? _worker : _threads.empty() ? 0 : 1 + _next++ % _threads.size() };
+
+			// Counted before it is published: a worker may take the task as soon as it is queued, and its decrement
+			// must not run ahead of this increment.
+			{
+				std::lock_guard<std::mutex> lock{ _mutex };
+				++_pending;
+			}
+
+			{
+				std::lock_guard<std::mutex> lock{ _queues[queue]->mutex };
+				_queues[queue]->tasks.push_back(std::move(task));
+			}
+			_condition.notify_one();
+		}
+
+		template<typename Function>
+		void run(size_t taskCount, Function&& function) {
+			std::atomic<size_t> remaining{ taskCount };
+
+			for (size_t _index{}; _index < taskCount; ++_index) {
+				submit([&function, &remaining, _index]() {
+					function(_index);
+					remaining.fetch_sub(1, std::memory_order_release);
+				});
+			}
+
+			wait([&remaining]() {
+				return remaining.load(std::memory_order_acquire) == 0;
+			});
+		}
+
+		template<typename Predicate>
+		void wait(Predicate&& done) {
+			size_t self{ _owner == this ? _worker : 0 };
+			while (!done()) {
+				Task task;
+				if (take(self, task)) {
+					task();
+				}
+				else {
+					std::this_thread::yield();
+				}
+			}
+		}
+
+	private:
+		void work(size_t _index) {
+			_owner = this;
+			_worker = _index;
+
+			while (true) {
+				Task task;
+				if (take(_index, task)) {
+					task();
+					continue;
+				}
+
+				std::unique_lock<std::mutex> lock{ _mutex };
+				_condition.wait(lock, [this]() {
+					return _stop || _pending.load() != 0;
+				});
+
+				if (_stop && _pending.load() == 0) {
+					return;
+				}
+			}
+		}
+
+		bool take(size_t self, Task& task) {
+			if (pop(self, task)) {
+				return true;
+			}
+
+			for (size_t offset{ 1 }; offset < _queues.size(); ++offset) {
+				if (steal((self + offset) % _queues.size(), task)) {
+					return true;
+				}
+			}
+
+			return false;
+		}
+
+		bool pop(size_t queue, Task& task) {
+			std::lock_guard<std::mutex> lock{ _queues[queue]->mutex };
+
+			if (_queues[queue]->tasks.empty()) {
+				return false;
+			}
+
+			task = std::move(_queues[queue]->tasks.back());
+			_queues[queue]->tasks.pop_back();
+			--_pending;
+			return true;
+		}
+
+		bool steal(size_t queue, Task& task) {
+			std::lock_guard<std::mutex> lock{ _queues[queue]->mutex };
+
+			if (_queues[queue]->tasks.empty()) {
+				return false;
+			}
+
+			task = std::move(_queues[queue]->tasks.front());
+			_queues[queue]->tasks.pop_front();
+			--_pending;
+			return true;
+		}
+	};
+
+}
\ No newline at end of file
@@ -2,6 +2,9 @@
 
 #include <cstdint>
 #include <type_traits>
+#include <algorithm>
+#include <vector>
+#include <span>
 
 #include "world.h"
 
@@ -13,59 +16,134 @@ namespace Byte {
 		using Archetype = typename WorldType::Archetype;
 		using Signature = typename WorldType::Signature;
 		using EntityID = typename WorldType::EntityID;
+		using EntityData = typename WorldType::EntityData;
 		using IDContainer = std::vector<EntityID>;
 
-		template<typename Component, typename... Components>
-		static IDContainer spawn(
-			World& world, 
-			size_t count, 
-			Component&& component, 
-			Components&&... components) {
-			Signature signature{ Signature::template build<Component, Components...>() };
+		inline static constexpr size_t PARALLEL_GRAIN{ 16384 };
 
-			Archetype* dest;
+		template<typename Argument>
+		struct ComponentOf {
+			using type = std::decay_t<Argument>;
+		};
 
-			auto result{ world._arches.find(signature) };
-			if (result != world._arches.end()) {
-				dest = &result->second;
+		template<typename Argument>
+			requires std::is_invocable_v<Argument&, size_t>
+		struct ComponentOf<Argument> {
+			using type = std::decay_t<std::invoke_result_t<Argument&, size_t>>;
+		};
+
+		// Each argument is either a prototype copied into every entity or a callable mapping the batch index to a component.
+		template<typename... Arguments>
+		static IDContainer spawn(World& world, size_t count, Arguments&&... arguments) {
+			return spawnBatch<false>(world, count, arguments...);
+		}
+
+		// Like spawn, but initializer callables run on the world's thread pool and must be safe to call concurrently.
+		template<typename... Arguments>
+		static IDContainer parallelSpawn(World& world, size_t count, Arguments&&... arguments) {
+			return spawnBatch<true>(world, count, arguments...);
+		}
+
+	private:
+		template<bool Parallel, typename... Arguments>
+		static IDContainer spawnBatch(World& world, size_t count, Arguments&... arguments) {
+			constexpr bool DENSE{ (!SPARSE_STORAGE<typename ComponentOf<Arguments>::type> || ...) };
+
+			IDContainer out(count);
+			world.generate(std::span<EntityID>{ out });
+			world._entities.reserve(world._entities.size() + count);
+
+			Archetype* dest{ nullptr };
+			size_t first{};
+
+			if constexpr (DENSE) {
+				dest = target<typename ComponentOf<Arguments>::type...>(world);
+				first = dest->size();
+				dest->reserve(first + count);
+
+				for (size_t idx{}; idx < count; ++idx) {
+					dest->pushEntity(out[idx]);
+					world._entities.emplace(out[idx], EntityData{ first + idx, dest });
+				}
 			}
 			else {
-				world._arches[signature] = Archetype::template build<Component, Components...>();
-				dest = &world._arches[signature];
+				for (EntityID id : out) {
+					world._entities.emplace(id, EntityData{});
+				}
 			}
 
-			dest->reserve(dest->size() + count);
+			(fill<Parallel>(world, dest, out, arguments), ...);
 
-			IDContainer out;
-			out.reserve(dest->size() + count);
-			world._entities.reserve(count);
-			for (size_t idx{}; idx < count; ++idx) {
-				EntityID id{ world.createEntity() };
-				typename World::EntityData& data{ world._entities.at(id) };
+			if constexpr (DENSE) {
+				world.notifyRows(Signature{}, *dest, first);
+			}
+			return out;
+		}
 
-				data.arche = dest;
-				data._index = push(id, dest, component, components...);
+		template<typename... Components>
+		static Archetype* target(World& world) {
+			Signature signature{ World::template denseSignature<EntityID, Components...>() };
 
-				out.push_back(id);
+			auto result{ world._arches.find(signature) };
+			if (result != world._arches.end()) {
+				return &result->second;
 			}
 
-			return out;
+			Archetype arche{ world._resource };
+			(emplaceDense<Components>(arche), ...);
+			return world.emplaceArchetype(signature, std::move(arche));
 		}
 
-	private:
-		template<typename Component, typename... Components>
-		static size_t push(
-			EntityID id, 
-			Archetype* dest, 
-			Component component, 
-			Components... components) {
-			size_t _index{ dest->pushEntity(id) };
-
-			dest->pushComponent<Component>(std::forward<Component>(component));
-			(dest->pushComponent<Components>(std::forward<Components>(components)), ...);
-
-			return _index;
+		template<typename Component>
+		static void emplaceDense(Archetype& arche) {
+			if constexpr (!SPARSE_STORAGE<Component>) {
+				arche.template emplaceAccessor<Component>();
+			}
+		}
+
+		template<bool Parallel, typename Argument>
+		static void fill(World& world, Archetype* dest, const IDContainer& ids, Argument& argument) {
+			using Component = typename ComponentOf<Argument>::type;
+			constexpr bool GENERATED{ std::is_invocable_v<Argument&, size_t> };
+
+			if constexpr (SPARSE_STORAGE<Component>) {
+				for (size_t idx{}; idx < ids.size(); ++idx) {
+					if constexpr (GENERATED) {
+						world.attachSparse(ids[idx], argument(idx));
+					}
+					else {
+						world.attachSparse(ids[idx], argument);
+					}
+				}
+			}
+			else if constexpr (TAG_COMPONENT<Component>) {
+				return;
+			}
+			else if constexpr (!GENERATED) {
+				dest->pushComponents(ids.size(), static_cast<const Component&>(argument));
+			}
+			else {
+				auto& column{ dest->columnAccessor(Registry<Component>::id())->template receive<Component>() };
+				size_t first{ column.size() };
+
+				if constexpr (Parallel && std::is_default_constructible_v<Component>) {
+					dest->pushComponents(ids.size(), Component{});
+
+					size_t tasks{ (ids.size() + PARALLEL_GRAIN - 1) / PARALLEL_GRAIN };
+					world.threadPool().run(tasks, [&column, &argument, first, count{ ids.size() }](size_t task) {
+						size_t last{ std::min(count, (task + 1) * PARALLEL_GRAIN) };
+						for (size_t idx{ task * PARALLEL_GRAIN }; idx < last; ++idx) {
+							*column.data(first + idx) = argument(idx);
+						}
+					});
+				}
+				else {
+					for (size_t idx{}; idx < ids.size(); ++idx) {
+						column.pushBack(argument(idx));
+					}
+				}
+			}
 		}
 	};
 
-}
\ No newline at end of file
+}
@@ -3,14 +3,44 @@
 #include <unordered_map>
 #include <type_traits>
 #include <vector>
+#include <span>
+#include <algorithm>
+#include <memory>
+#include <memory_resource>
+#include <tuple>
+#include <array>
+#include <utility>
+#include <string>
+#include <limits>
+#include <cstring>
 
 #include "archetype.h"
 #include "component.h"
 #include "signature.h"
 #include "hash_map.h"
+#include "entity_table.h"
+#include "thread_pool.h"
+#include "command_buffer.h"
+#include "observer.h"
+#include "sparse_set.h"
+#include "snapshot.h"
+#include "mapped_file.h"
+#include "delta.h"
 
 namespace Byte {
 
+	template<typename EntityIDGenerator, typename EntityID, typename Value>
+	struct EntityMapOf {
+		using type = hash_map<EntityID, Value, std::hash<EntityID>, std::equal_to<EntityID>, group_probe,
+			std::pmr::polymorphic_allocator<std::pair<EntityID, Value>>>;
+	};
+
+	template<typename EntityIDGenerator, typename EntityID, typename Value>
+	requires requires { typename EntityIDGenerator::template Table<Value>; }
+	struct EntityMapOf<EntityIDGenerator, EntityID, Value> {
+		using type = typename EntityIDGenerator::template Table<Value>;
+	};
+
 	template<
 	typename _EntityID,
 	template<typename> class _EntityIDGenerator,
@@ -24,8 +54,8 @@ namespace Byte {
 		using EntityIDGenerator = _EntityIDGenerator<EntityID>;
 		template<typename Component>
 		using Container = _Container<Component>;
-		using Archetype = Archetype<EntityID, Container, MAX_COMPONENT_COUNT>;
-		using Signature = Signature<MAX_COMPONENT_COUNT>;
+		using Archetype = Byte::Archetype<EntityID, Container, MAX_COMPONENT_COUNT>;
+		using Signature = Byte::Signature<MAX_COMPONENT_COUNT>;
 		using ArcheMap = std::unordered_map<Signature, Archetype>;
 
 		struct EntityData {
@@ -33,7 +63,33 @@ namespace Byte {
 			Archetype* arche{ nullptr };
 		};
 
-		using EntityMap = hash_map<EntityID, EntityData>;
+		using EntityMap = typename EntityMapOf<EntityIDGenerator, EntityID, EntityData>::type;
+
+		template<typename... Components>
+		class View;
+
+		using ArcheVector = std::vector<Archetype*>;
+
+		struct QueryState {
+			Signature signature;
+			ArcheVector arches;
+		};
+
+		using QueryMap = std::unordered_map<Signature, std::unique_ptr<QueryState>>;
+		using ComponentIndex = std::vector<ArcheVector>;
+		using Observers = Byte::Observers<EntityID, MAX_COMPONENT_COUNT>;
+		using SparseIndex = typename EntityMapOf<EntityIDGenerator, EntityID, size_t>::type;
+		using ISparseSet = Byte::ISparseSet<EntityID, SparseIndex>;
+		template<typename Component>
+		using SparseSet = Byte::SparseSet<EntityID, Component, SparseIndex>;
+		using SparseSetVector = std::vector<USparseSet<EntityID, SparseIndex>>;
+
+		struct ColumnType {
+			typename Archetype::UAccessor(*accessor)(std::pmr::memory_resource*) { nullptr };
+			USparseSet<EntityID, SparseIndex>(*sparse)(std::pmr::memory_resource*) { nullptr };
+		};
+
+		using ColumnTypeVector = std::vector<ColumnType>;
 
 	private:
 		template<typename WorldType>
@@ -41,9 +97,25 @@ namespace Byte {
 
 		ArcheMap _arches;
 		EntityMap _entities;
+		ComponentIndex _componentArches;
+		QueryMap _queries;
+		std::unique_ptr<Tick> _clock{ std::make_unique<Tick>(1) };
+		Observers _observers;
+		SparseSetVector _sparseSets;
+		std::shared_ptr<ThreadPool> _pool;
+		std::pmr::memory_resource* _resource;
+
+		inline static ColumnTypeVector _columnTypes;
 
 	public:
-		_World() = default;
+		_World()
+			: _World{ std::pmr::get_default_resource() } {
+		}
+
+		// Columns whose container takes a polymorphic_allocator and the entity map allocate from resource, which must outlive the world.
+		explicit _World(std::pmr::memory_resource* resource)
+			: _entities{ typename EntityMap::allocator_type{ resource } }, _resource{ resource } {
+		}
 
 		_World(const _World& left)
 			: _World{ left.copy() } {
@@ -59,11 +131,41 @@ namespace Byte {
 		_World& operator=(_World&& right) noexcept = default;
 
 		EntityID create() {
-			EntityID id{ EntityIDGenerator::generate() };
+			EntityID id{ generate() };
 			_entities.emplace(id,EntityData{});
 			return id;
 		}
 
+		EntityID generate() {
+			if constexpr (requires(EntityMap& map) { map.generate(); }) {
+				return _entities.generate();
+			}
+			else {
+				return EntityIDGenerator::generate();
+			}
+		}
+
+		// Takes an id without touching the entity table, so command buffers can call it while systems read the world.
+		EntityID reserveEntity() requires requires(EntityMap& map) { map.reserve_key(); } {
+			return _entities.reserve_key();
+		}
+
+		// Hands back a reserved id that was never created, e.g. from a command buffer cleared without apply().
+		void releaseEntity(EntityID id) requires requires(EntityMap& map) { map.release_key(id); } {
+			_entities.release_key(id);
+		}
+
+		void generate(std::span<EntityID> out) {
+			if constexpr (requires(EntityMap& map) { map.generate(out); }) {
+				_entities.generate(out);
+			}
+			else {
+				for (EntityID& id : out) {
+					id = EntityIDGenerator::generate();
+				}
+			}
+		}
+
 		template<typename Component, typename... Components>
 		EntityID create(Component&& component, Components&&... components) {
 			EntityID out{ create() };
@@ -76,245 +178,2060 @@ namespace Byte {
 
 		void destroy(EntityID id) {
 			EntityData& data{ _entities.at(id) };
-			data.arche->erase(data._index);
+			if (_observers.active() && data.arche) {
+				_observers.record(ObserverEvent::DESTROY, data.arche->signature(), id);
+			}
+			eraseSparse(id);
+			if (data.arche) {
+				EntityID changedEntity{ data.arche->erase(data._index) };
+				_entities[changedEntity]._index = data._index;
+			}
 			_entities.erase(id);
 		}
 
+		void destroyMany(std::span<const EntityID> ids) {
+			for (auto& pair : group(ids)) {
+				if (!pair.first) {
+					continue;
+				}
+
+				IndexVector indices;
+				indices.reserve(pair.second.size());
+				for (const Row& row : pair.second) {
+					indices.push_back(row.first);
+				}
+				destroyRows(*pair.first, indices);
+			}
+
+			for (EntityID id : ids) {
+				if (_entities.find(id) != _entities.end()) {
+					eraseSparse(id);
+					_entities.erase(id);
+				}
+			}
+		}
+
+		template<typename... Components>
+		void destroyAll(View<Components...>& view) {
+			if (View<Components...>::SPARSE || view.filtered()) {
+				std::vector<EntityID> ids{ view.entities() };
+				destroyMany(ids);
+				return;
+			}
+
+			ArcheVector arches{ view.archetypes() };
+			for (Archetype* arche : arches) {
+				destroyArchetype(*arche);
+			}
+		}
+
+		template<typename... Components, typename Predicate>
+		void destroyIf(View<Components...>& view, Predicate&& predicate) {
+			std::vector<EntityID> ids;
+			view.each([&ids, &predicate](EntityID id, Components&... components) {
+				bool destroyed;
+				if constexpr (std::is_invocable_v<Predicate&, EntityID, Components&...>) {
+					destroyed = predicate(id, components...);
+				}
+				else {
+					destroyed = predicate(components...);
+				}
+
+				if (destroyed) {
+					ids.push_back(id);
+				}
+			});
+			destroyMany(ids);
+		}
+
 		EntityID clone(EntityID source) {
 			EntityID out{ create() };
 			EntityData& sourceData{ _entities.at(source) };
-			sourceData.arche->copyEntity(sourceData._index, out, *sourceData.arche);
-			_entities.at(out).arche = sourceData.arche;
+			EntityData& outData{ _entities.at(out) };
+
+			if (sourceData.arche) {
+				outData._index = sourceData.arche->copyEntity(sourceData._index, out, *sourceData.arche);
+				outData.arche = sourceData.arche;
+
+				if (_observers.active()) {
+					notify(Signature{}, outData.arche->signature(), out);
+				}
+			}
+
+			for (ComponentID component{}; component < _sparseSets.size(); ++component) {
+				if (_sparseSets[component] && _sparseSets[component]->copyEntity(source, out)) {
+					notify(ObserverEvent::ADD, component, out);
+				}
+			}
 			return out;
 		}
 
 		template<typename Component, typename... Components>
 		void attach(EntityID id, Component&& component, Components&&... components) {
-			Signature signature{ Signature::template build<EntityID,Component,Components...>() };
-
-			EntityData& data{ _entities.at(id) };
-
-			Archetype* oldArche{ data.arche };
-			Archetype* newArche{ nullptr };
-
-			if (oldArche) {
-				signature += oldArche->signature();
+			if constexpr (SPARSE_STORAGE<std::decay_t<Component>> && sizeof...(Components) == 0) {
+				attachSparse(id, std::forward<Component>(component));
 			}
-
-			auto result{ _arches.find(signature) };
-			if (result != _arches.end()){
-				newArche = &result->second;
+			else if constexpr ((SPARSE_STORAGE<std::decay_t<Component>> || ... || SPARSE_STORAGE<std::decay_t<Components>>)) {
+				attach(id, std::forward<Component>(component));
+				(attach(id, std::forward<Components>(components)), ...);
 			}
 			else {
+				EntityData& data{ _entities.at(id) };
+
+				Archetype* oldArche{ data.arche };
+				Archetype* newArche{ attachTarget<Component, Components...>(oldArche) };
+
+				if (newArche == oldArche) {
+					placeComponent(*newArche, oldArche, data._index, std::forward<Component>(component));
+					(placeComponent(*newArche, oldArche, data._index, std::forward<Components>(components)), ...);
+					return;
+				}
+
+				size_t newIndex;
 				if (oldArche) {
-					_arches.emplace(signature,Archetype::template build<Component, Components...>(*oldArche));
+					auto [carriedIndex, changedEntity] { newArche->transferEntity(data._index, id, *oldArche) };
+					_entities[changedEntity]._index = data._index;
+					newIndex = carriedIndex;
 				}
 				else {
-					_arches.emplace(signature,Archetype::template build<Component, Components...>());
+					newIndex = newArche->pushEntity(id);
 				}
-				newArche = &_arches[signature];
-			}
 
-			size_t newIndex;
-			if (oldArche) {
-				newIndex = newArche->carryEntity(data._index, id, *oldArche);
+				placeComponent(*newArche, oldArche, newIndex, std::forward<Component>(component));
+				(placeComponent(*newArche, oldArche, newIndex, std::forward<Components>(components)), ...);
+
+				data.arche = newArche;
+				data._index = newIndex;
+
+				if (_observers.active()) {
+					notify(oldArche ? oldArche->signature() : Signature{}, newArche->signature(), id);
+				}
+			}
+		}
 
-				EntityID changedEntity{ oldArche->erase(data._index) };
-				_entities[changedEntity]._index = _entities[id]._index;
+		template<typename Component>
+		void attachMany(std::span<const EntityID> ids, const Component& component) {
+			if constexpr (SPARSE_STORAGE<std::decay_t<Component>>) {
+				for (EntityID id : ids) {
+					attachSparse(id, component);
+				}
 			}
 			else {
-				newIndex = newArche->pushEntity(id);
+				for (auto& pair : group(ids)) {
+					Archetype* oldArche{ pair.first };
+
+					if (oldArche && oldArche->signature().test(Registry<std::decay_t<Component>>::id())) {
+						if constexpr (!TAG_COMPONENT<std::decay_t<Component>>) {
+							for (const Row& row : pair.second) {
+								oldArche->template getComponent<std::decay_t<Component>>(row.first) = component;
+							}
+						}
+						continue;
+					}
+
+					Archetype* newArche{ attachTarget<Component>(oldArche) };
+
+					if (oldArche) {
+						size_t first{ newArche->size() };
+						moveGroup(*oldArche, *newArche, pair.second);
+						newArche->pushComponents(pair.second.size(), component);
+						notifyRows(oldArche->signature(), *newArche, first);
+					}
+					else {
+						size_t first{ newArche->size() };
+						for (EntityID id : ids) {
+							EntityData& data{ _entities.at(id) };
+							if (!data.arche) {
+								data._index = newArche->pushEntity(id);
+								data.arche = newArche;
+								newArche->pushComponent(component);
+							}
+						}
+						notifyRows(Signature{}, *newArche, first);
+					}
+				}
 			}
+		}
 
-			newArche->pushComponent(std::forward<Component>(component));
-			(newArche->pushComponent(std::forward<Components>(components)), ...);
+		template<typename Component, typename... Components>
+		void attachMany(View<Components...>& view, const Component& component) {
+			constexpr bool byEntity{ SPARSE_STORAGE<std::decay_t<Component>> || View<Components...>::SPARSE };
 
-			data.arche = newArche;
-			data._index = newIndex;
+			// Filters select rows, not archetypes, so filtered views go entity by entity as in destroyAll.
+			if (byEntity || view.filtered()) {
+				std::vector<EntityID> ids{ view.entities() };
+				attachMany(std::span<const EntityID>{ ids }, component);
+			}
+			else if constexpr (!byEntity) {
+				ArcheVector arches{ view.archetypes() };
+
+				for (Archetype* oldArche : arches) {
+					if (oldArche->signature().test(Registry<std::decay_t<Component>>::id())) {
+						if constexpr (!TAG_COMPONENT<std::decay_t<Component>>) {
+							for (size_t _index{}; _index < oldArche->size(); ++_index) {
+								oldArche->template getComponent<std::decay_t<Component>>(_index) = component;
+							}
+						}
+						continue;
+					}
+
+					Archetype* newArche{ attachTarget<Component>(oldArche) };
+					size_t first{ newArche->size() };
+					size_t count{ oldArche->size() };
+					moveAll(*oldArche, *newArche);
+					newArche->pushComponents(count, component);
+					notifyRows(oldArche->signature(), *newArche, first);
+				}
+			}
 		}
 
 		template<typename Component>
 		void detach(EntityID id) {
-			EntityData& data{ _entities.at(id) };
+			if constexpr (SPARSE_STORAGE<std::decay_t<Component>>) {
+				detachSparse(Registry<std::decay_t<Component>>::id(), id);
+			}
+			else {
+				EntityData& data{ _entities.at(id) };
 
-			Archetype* oldArche{ data.arche };
+				Archetype* oldArche{ data.arche };
+				if (!oldArche || !oldArche->signature().test(Registry<Component>::id())) {
+					return;
+				}
 
-			Signature signature{ oldArche->signature() };
-			signature.set(Registry<Component>::id(), false);
+				Archetype* newArche{ detachTarget<Component>(oldArche) };
 
-			size_t newIndex{ 0 };
-			Archetype* newArche{ nullptr };
+				auto [newIndex, changedEntity] { newArche->transferEntity(data._index, id, *oldArche) };
+				_entities[changedEntity]._index = data._index;
 
-			if (signature.any()) {
-				auto result{ _arches.find(signature) };
+				data._index = newIndex;
+				data.arche = newArche;
 
-				if (result == _arches.end()) {
-					_arches.emplace(signature, Archetype::build(*oldArche, Registry<Component>::id()));
-					newArche = &_arches[signature];
+				if (_observers.active()) {
+					notify(oldArche->signature(), newArche->signature(), id);
 				}
-				else {
-					newArche = &result->second;
+			}
+		}
+
+		template<typename Component>
+		void detachMany(std::span<const EntityID> ids) {
+			if constexpr (SPARSE_STORAGE<std::decay_t<Component>>) {
+				for (EntityID id : ids) {
+					detach<Component>(id);
+				}
+			}
+			else {
+				for (auto& pair : group(ids)) {
+					Archetype* oldArche{ pair.first };
+
+					if (oldArche && oldArche->signature().test(Registry<Component>::id())) {
+						Archetype* newArche{ detachTarget<Component>(oldArche) };
+						size_t first{ newArche->size() };
+						moveGroup(*oldArche, *newArche, pair.second);
+						notifyRows(oldArche->signature(), *newArche, first);
+					}
 				}
-				newIndex = newArche->carryEntity(data._index, id, *oldArche);
 			}
-			EntityID changedEntity{ oldArche->erase(data._index) };
-			_entities[changedEntity]._index = data._index;
+		}
 
-			data._index = newIndex;
-			data.arche = newArche;
+		template<typename Component, typename... Components>
+		void detachMany(View<Components...>& view) {
+			constexpr bool byEntity{ SPARSE_STORAGE<std::decay_t<Component>> || View<Components...>::SPARSE };
+
+			if (byEntity || view.filtered()) {
+				std::vector<EntityID> ids{ view.entities() };
+				detachMany<Component>(std::span<const EntityID>{ ids });
+			}
+			else if constexpr (!byEntity) {
+				ArcheVector arches{ view.archetypes() };
+
+				for (Archetype* oldArche : arches) {
+					if (oldArche->signature().test(Registry<Component>::id())) {
+						Archetype* newArche{ detachTarget<Component>(oldArche) };
+						size_t first{ newArche->size() };
+						moveAll(*oldArche, *newArche);
+						notifyRows(oldArche->signature(), *newArche, first);
+					}
+				}
+			}
+		}
+
+		void apply(CommandBuffer<_World>& buffer) {
+			CommandBuffer<_World>* buffers[]{ &buffer };
+			playback(buffers);
+		}
+
+		void apply(ParallelCommandBuffer<_World>& buffer) {
+			std::vector<CommandBuffer<_World>*> buffers;
+			for (auto& local : buffer.buffers()) {
+				buffers.push_back(local.get());
+			}
+			playback(buffers);
 		}
 
 		template<typename Component>
 		Component& get(EntityID id) {
-			EntityData& data{ _entities.at(id) };
-			return data.arche->getComponent<Component>(data._index);
+			if constexpr (SPARSE_STORAGE<std::decay_t<Component>>) {
+				return sparseSet<std::decay_t<Component>>().get(id);
+			}
+			else {
+				EntityData& data{ _entities.at(id) };
+				return data.arche->template getComponent<Component>(data._index);
+			}
 		}
 
 		template<typename Component>
 		const Component& get(EntityID id) const {
-			EntityData& data{ _entities.at(id) };
-			return data.arche->getComponent<Component>(data._index);
+			if constexpr (SPARSE_STORAGE<std::decay_t<Component>>) {
+				const ISparseSet* set{ sparseSet(Registry<std::decay_t<Component>>::id()) };
+				if (!set) {
+					throw std::out_of_range("Key not found");
+				}
+				return set->template receive<std::decay_t<Component>>().get(id);
+			}
+			else {
+				const EntityData& data{ _entities.at(id) };
+				return static_cast<const Archetype*>(data.arche)->template getComponent<Component>(data._index);
+			}
 		}
 
-		template<typename Component>
-		bool has(EntityID id) {
-			Archetype* arche{ _entities.at(id).arche };
+		template<typename... Components, typename Function>
+		void gather(std::span<const EntityID> ids, Function&& function) {
+			static_assert(!(SPARSE_STORAGE<std::decay_t<Components>> || ...), "gather() reads archetype columns; sparse components are fetched with get()");
+			using Cache = typename Archetype::template Cache<Components...>;
 
-			if (arche) {
-				return arche->signature().test(Registry<Component>::id());
-			}
+			Signature signature{ Signature::template build<Components...>() };
+			EntityData* datas[GATHER_BATCH];
+			Cache caches[GATHER_BATCH];
 
-			return false;
-		}
-		
-		size_t size() const {
-			return _entities.size();
-		}
+			Archetype* lastArche{ nullptr };
+			Cache lastCache;
+			bool lastMatches{ false };
 
-		_World copy() const {
-			_World out;
-			out._arches = _arches;
-			out._entities = _entities;
+			for (size_t first{}; first < ids.size(); first += GATHER_BATCH) {
+				size_t count{ std::min(GATHER_BATCH, ids.size() - first) };
+				_entities.find_batch(ids.subspan(first, count), std::span<EntityData*>{ datas, count });
 
-			for (auto pair: _entities) {
-				auto& test{ out._entities.at(pair.first) };
-				auto& test2{ out._arches.at(pair.second.arche->signature()) };
-				out._entities.at(pair.first).arche = &out._arches.at(pair.second.arche->signature());
-			}
+				for (size_t _index{}; _index < count; ++_index) {
+					EntityData* data{ datas[_index] };
+					if (!data || !data->arche) {
+						datas[_index] = nullptr;
+						continue;
+					}
 
-			return out;
+					if (data->arche != lastArche) {
+						lastArche = data->arche;
+						lastMatches = lastArche->signature().includes(signature);
+						if (lastMatches) {
+							lastCache = Cache{ *lastArche };
+						}
+					}
+
+					if (!lastMatches) {
+						datas[_index] = nullptr;
+						continue;
+					}
+
+					caches[_index] = lastCache;
+					caches[_index].prefetch(data->_index);
+				}
+
+				for (size_t _index{}; _index < count; ++_index) {
+					if (datas[_index]) {
+						visit(ids[first + _index], caches[_index].group(datas[_index]->_index), function);
+					}
+				}
+			}
 		}
 
-		template<typename... Components>
-		class ViewIterator {
-		public:
-			using ArcheVector = std::vector<Archetype*>;
-			using Cache = Archetype::template Cache<Components...>;
-			using ComponentGroup = typename Cache::ComponentGroup;
+		template<typename... Components, typename Function>
+		void gatherGrouped(std::span<const EntityID> ids, Function&& function) {
+			static_assert(!(SPARSE_STORAGE<std::decay_t<Components>> || ...), "gather() reads archetype columns; sparse components are fetched with get()");
+			using Cache = typename Archetype::template Cache<Components...>;
 
-		private:
-			ArcheVector* _arches;
-			size_t _cacheIndex;
-			size_t _index;
-			Cache _cache;
+			Signature signature{ Signature::template build<Components...>() };
+			std::vector<EntityData*> datas(ids.size());
+			_entities.find_batch(ids, std::span<EntityData*>{ datas });
 
-		public:
-			ViewIterator(ArcheVector& _archeVector, size_t _cacheIndex, size_t _index)
-				: _arches{ &_archeVector }, _cacheIndex{ _cacheIndex }, _index{ _index } {
-				if (_cacheIndex < _arches->size()) {
-					_cache = Cache{ *_arches->at(_cacheIndex) };
+			ArcheGroups groups;
+			Archetype* lastArche{ nullptr };
+			RowVector* rows{ nullptr };
+
+			for (EntityData* data : datas) {
+				if (!data || !data->arche || !data->arche->signature().includes(signature)) {
+					continue;
 				}
+				if (data->arche != lastArche) {
+					lastArche = data->arche;
+					rows = &groups[lastArche];
+				}
+				rows->emplace_back(data->_index, data);
 			}
 
-			ViewIterator& operator++() {
-				++_index;
+			for (auto& pair : groups) {
+				Archetype& arche{ *pair.first };
+				sortRows(arche, pair.second);
 
-				if (_index == _cache.size()) {
-					_index = 0;
-					++_cacheIndex;
-					if (_cacheIndex != _arches->size()) {
-						_cache = Cache{ *_arches->at(_cacheIndex) };
+				Cache cache{ arche };
+				const RowVector& sorted{ pair.second };
+
+				for (size_t _index{}; _index < sorted.size(); ++_index) {
+					if (_index + GATHER_DISTANCE < sorted.size()) {
+						cache.prefetch(sorted[_index + GATHER_DISTANCE].first);
 					}
+					visit(arche.entity(sorted[_index].first), cache.group(sorted[_index].first), function);
 				}
-
-				return *this;
 			}
+		}
 
-			ComponentGroup operator*() {
-				return _cache.group(_index);
+		template<typename Component>
+		bool has(EntityID id) {
+			if constexpr (SPARSE_STORAGE<std::decay_t<Component>>) {
+				ISparseSet* set{ sparseSet(Registry<std::decay_t<Component>>::id()) };
+				return set && set->contains(id);
 			}
+			else {
+				Archetype* arche{ _entities.at(id).arche };
 
-			bool operator==(const ViewIterator& left) const {
-				return _cacheIndex == left._cacheIndex;
+				if (arche) {
+					return arche->signature().test(Registry<Component>::id());
+				}
+
+				return false;
 			}
+		}
+		
+		size_t size() const {
+			return _entities.size();
+		}
 
-			bool operator!=(const ViewIterator& left) const {
-				return !(*this == left);
+		template<typename Component, typename Function>
+		void onAdd(Function&& function) {
+			_observers.observe(ObserverEvent::ADD, Registry<std::decay_t<Component>>::id(), std::forward<Function>(function));
+		}
+
+		template<typename Component, typename Function>
+		void onRemove(Function&& function) {
+			_observers.observe(ObserverEvent::REMOVE, Registry<std::decay_t<Component>>::id(), std::forward<Function>(function));
+		}
+
+		template<typename Component, typename Function>
+		void onDestroy(Function&& function) {
+			_observers.observe(ObserverEvent::DESTROY, Registry<std::decay_t<Component>>::id(), std::forward<Function>(function));
+		}
+
+		void flush() {
+			_observers.flush();
+		}
+
+		Tick tick() const {
+			return *_clock;
+		}
+
+		Tick advance() {
+			return ++*_clock;
+		}
+
+		ThreadPool& threadPool() {
+			if (!_pool) {
+				_pool = std::make_shared<ThreadPool>();
 			}
+			return *_pool;
+		}
 
-		};
+		void threadPool(std::shared_ptr<ThreadPool> pool) {
+			_pool = std::move(pool);
+		}
+
+		_World copy() const {
+			return duplicate([](const Archetype& arche) {
+				return arche.copy();
+			});
+		}
+
+		std::pmr::memory_resource* resource() const {
+			return _resource;
+		}
+
+		// Shares every column with this world; each side duplicates a column the first time it mutates it.
+		_World fork() const {
+			return duplicate([](const Archetype& arche) {
+				return arche.share();
+			});
+		}
 
 		template<typename... Components>
-		class View {
-		public:
-			using ArcheVector = std::vector<Archetype*>;
-			using Iterator = ViewIterator<Components...>;
+		static void serializable() {
+			(registerColumnType<std::decay_t<Components>>(), ...);
+		}
 
-		private:
-			ArcheVector _archeVector;
+		void save(const std::string& path) const {
+			SnapshotWriter writer{ path };
 
-		public:
-			View(_World& world) {
-				Signature signature{ Signature::template build<Components...>() };
+			writer.value(SNAPSHOT_MAGIC);
+			writer.value<uint64_t>(SNAPSHOT_VERSION);
+			writer.value<uint64_t>(*_clock);
+			writer.value<uint64_t>(_entities.size());
 
-				for (auto& pair : world._arches) {
-					if (pair.second.signature().includes(signature) && !pair.second.empty()) {
-						_archeVector.push_back(&pair.second);
-					}
+			std::vector<const Archetype*> arches;
+			for (auto& pair : _arches) {
+				if (!pair.second.empty()) {
+					arches.push_back(&pair.second);
 				}
 			}
 
-			Iterator begin() {
-				return Iterator{ _archeVector,0,0 };
+			writer.value<uint64_t>(arches.size());
+			for (const Archetype* arche : arches) {
+				arche->save(writer);
 			}
 
-			Iterator end() {
-				return Iterator{ _archeVector, _archeVector.size(), 0 };
+			std::vector<EntityID> orphans;
+			for (auto pair : _entities) {
+				if (!pair.second.arche) {
+					orphans.push_back(pair.first);
+				}
 			}
+			saveColumn<EntityID>(writer, orphans.size(), orphans.size(), [&orphans](size_t first) {
+				return orphans.data() + first;
+			});
 
-			template<typename... _Components>
-			View include() {
-				Signature signature{ Signature::template build<_Components...>() };
-				ArcheVector newArches;
+			uint64_t sets{};
+			for (auto& set : _sparseSets) {
+				sets += set && set->size();
+			}
 
-				for (auto arche : _archeVector) {
-					if (!arche->signature().matches(signature) && !arche->empty()) {
-						newArches.push_back(arche);
-					}
+			writer.value(sets);
+			for (ComponentID component{}; component < _sparseSets.size(); ++component) {
+				if (_sparseSets[component] && _sparseSets[component]->size()) {
+					writer.value(ComponentIDGenerator::key(component));
+					_sparseSets[component]->save(writer);
 				}
+			}
+		}
 
-				_archeVector = newArches;
+		static _World load(const std::string& path, std::pmr::memory_resource* resource = std::pmr::get_default_resource()) {
+			mapped_file file{ path };
+			SnapshotReader reader{ file.data(), file.size() };
 
-				return *this;
+			if (reader.value<uint64_t>() != SNAPSHOT_MAGIC) {
+				throw std::runtime_error(path + " is not a world snapshot");
+			}
+			if (reader.value<uint64_t>() != SNAPSHOT_VERSION) {
+				throw std::runtime_error(path + " has an unsupported snapshot version");
 			}
 
-			template<typename... _Components>
-			View exclude() {
-				Signature signature{ Signature::template build<_Components...>() };
-				ArcheVector newArches;
+			_World out{ resource };
+			*out._clock = static_cast<Tick>(reader.value<uint64_t>());
+			out._entities.reserve(static_cast<size_t>(reader.value<uint64_t>()));
 
-				for (auto arche : _archeVector) {
-					if (!arche->signature().matches(signature) && !arche->empty()) {
-						newArches.push_back(arche);
-					}
-				}
+			uint64_t arches{ reader.value<uint64_t>() };
+			for (uint64_t _index{}; _index < arches; ++_index) {
+				Archetype loaded{ Archetype::load(reader, [resource](ComponentID id) {
+					return columnType(id).accessor(resource);
+				}, resource) };
 
-				_archeVector = newArches;
+				Signature signature{ loaded.signature() };
+				Archetype* arche{ out.emplaceArchetype(signature, std::move(loaded)) };
 
-				return *this;
+				size_t row{};
+				arche->template each<>([&out, arche, &row](EntityID id) {
+					out._entities.emplace(id, EntityData{ row++, arche });
+				});
 			}
 
-		};
+			std::vector<EntityID> orphans;
+			loadColumn<EntityID>(reader.block(), orphans);
+			for (EntityID id : orphans) {
+				out._entities.emplace(id, EntityData{});
+			}
+
+			uint64_t sets{ reader.value<uint64_t>() };
+			for (uint64_t _index{}; _index < sets; ++_index) {
+				ComponentID component{ ComponentIDGenerator::find(reader.value<ComponentKey>()) };
+
+				if (component >= out._sparseSets.size()) {
+					out._sparseSets.resize(component + 1);
+				}
+				out._sparseSets[component] = columnType(component).sparse(resource);
+				out._sparseSets[component]->load(reader);
+			}
+
+			return out;
+		}
+
+		// Encodes what changed since base, e.g. a copy() kept from the last replicated tick, so that patch() on a world in base's state reproduces this one.
+		std::vector<std::byte> diff(const _World& base) const {
+			std::vector<std::byte> out;
+			SnapshotWriter writer{ out };
+
+			writer.value(DELTA_MAGIC);
+			writer.varint(*_clock);
+
+			std::vector<EntityID> destroyed;
+			for (auto& pair : base._arches) {
+				auto result{ _arches.find(pair.first) };
+				const Archetype* aligned{ result != _arches.end() ? &result->second : nullptr };
+
+				for (size_t _index{}; _index < pair.second.size(); ++_index) {
+					EntityID id{ pair.second.entity(_index) };
+					bool moved{ !aligned || _index >= aligned->size() || aligned->entity(_index) != id };
+					if (moved && _entities.find(id) == _entities.end()) {
+						destroyed.push_back(id);
+					}
+				}
+			}
+			for (auto pair : base._entities) {
+				if (!pair.second.arche && _entities.find(pair.first) == _entities.end()) {
+					destroyed.push_back(pair.first);
+				}
+			}
+			writeEntities(writer, destroyed);
+
+			std::vector<EntityID> orphans;
+			for (auto pair : _entities) {
+				if (!pair.second.arche) {
+					auto result{ base._entities.find(pair.first) };
+					if (result == base._entities.end() || result->second.arche) {
+						orphans.push_back(pair.first);
+					}
+				}
+			}
+			writeEntities(writer, orphans);
+
+			std::vector<std::byte> arches;
+			uint64_t archeCount{};
+			for (auto& pair : _arches) {
+				archeCount += diffArchetype(pair.second, base, arches);
+			}
+			writer.varint(archeCount);
+			writer.write(arches.data(), arches.size());
+
+			std::vector<std::byte> sets;
+			uint64_t setCount{};
+			for (ComponentID component{}; component < std::max(_sparseSets.size(), base._sparseSets.size()); ++component) {
+				setCount += diffSparse(component, base, sets);
+			}
+			writer.varint(setCount);
+			writer.write(sets.data(), sets.size());
+
+			return out;
+		}
+
+		void patch(std::span<const std::byte> delta) {
+			SnapshotReader reader{ delta };
+
+			if (reader.value<uint64_t>() != DELTA_MAGIC) {
+				throw std::runtime_error("Buffer is not a world delta");
+			}
+			*_clock = static_cast<Tick>(reader.varint());
+
+			for (EntityID id : readEntities(reader)) {
+				if (_entities.find(id) != _entities.end()) {
+					destroy(id);
+				}
+			}
+
+			for (EntityID id : readEntities(reader)) {
+				moveEntity(id, nullptr);
+			}
+
+			std::vector<std::byte> stream;
+			IndexVector rows;
+
+			uint64_t arches{ reader.varint() };
+			for (uint64_t _index{}; _index < arches; ++_index) {
+				Signature signature;
+				uint64_t keys{ reader.varint() };
+				for (uint64_t key{}; key < keys; ++key) {
+					signature.set(ComponentIDGenerator::find(reader.value<ComponentKey>()));
+				}
+
+				Archetype* arche{ archetype(signature) };
+
+				rows.clear();
+				for (EntityID id : readEntities(reader)) {
+					rows.push_back(moveEntity(id, arche));
+				}
+
+				for (size_t column{ 1 }; column < arche->columnIDs().size(); ++column) {
+					typename Archetype::IAccessor* accessor{ arche->columnAccessor(ComponentIDGenerator::find(reader.value<ComponentKey>())) };
+					if (!accessor) {
+						throw std::runtime_error("World delta column does not match its archetype");
+					}
+
+					decodeRuns(reader, stream);
+					SnapshotReader source{ stream };
+					for (size_t row : rows) {
+						accessor->patch(row, source);
+					}
+				}
+			}
+
+			uint64_t sets{ reader.varint() };
+			for (uint64_t _index{}; _index < sets; ++_index) {
+				ComponentID component{ ComponentIDGenerator::find(reader.value<ComponentKey>()) };
+
+				if (component >= _sparseSets.size()) {
+					_sparseSets.resize(component + 1);
+				}
+				if (!_sparseSets[component]) {
+					_sparseSets[component] = columnType(component).sparse(_resource);
+				}
+				ISparseSet* set{ _sparseSets[component].get() };
+
+				for (EntityID id : readEntities(reader)) {
+					if (set->erase(id)) {
+						notify(ObserverEvent::REMOVE, component, id);
+					}
+				}
+
+				std::vector<EntityID> changed{ readEntities(reader) };
+				decodeRuns(reader, stream);
+				SnapshotReader source{ stream };
+				for (EntityID id : changed) {
+					if (set->patch(id, source)) {
+						notify(ObserverEvent::ADD, component, id);
+					}
+				}
+			}
+		}
+
+	private:
+		inline static constexpr size_t GATHER_BATCH{ 32 };
+		inline static constexpr size_t GATHER_DISTANCE{ 8 };
+
+		using IndexVector = std::vector<size_t>;
+		using Row = std::pair<size_t, EntityData*>;
+		using RowVector = std::vector<Row>;
+		using ArcheGroups = std::unordered_map<Archetype*, RowVector>;
+
+		Archetype* emplaceArchetype(const Signature& signature, Archetype&& arche) {
+			Archetype* out{ &_arches.emplace(signature, std::move(arche)).first->second };
+			out->clock(_clock.get());
+			indexArchetype(out);
+
+			for (auto& pair : _queries) {
+				if (signature.includes(pair.first)) {
+					pair.second->arches.push_back(out);
+				}
+			}
+
+			return out;
+		}
+
+		template<typename Function>
+		_World duplicate(Function&& function) const {
+			_World out{ _resource };
+			out._entities = _entities;
+			out._pool = _pool;
+			*out._clock = *_clock;
+
+			out._sparseSets.resize(_sparseSets.size());
+			for (size_t _index{}; _index < _sparseSets.size(); ++_index) {
+				if (_sparseSets[_index]) {
+					out._sparseSets[_index] = _sparseSets[_index]->copy();
+				}
+			}
+
+			std::unordered_map<const Archetype*, Archetype*> arches;
+			arches.reserve(_arches.size());
+			out._arches.reserve(_arches.size());
+
+			for (auto& pair : _arches) {
+				Archetype* arche{ &out._arches.emplace(pair.first, function(pair.second)).first->second };
+				arche->clock(out._clock.get());
+				out.indexArchetype(arche);
+				arches.emplace(&pair.second, arche);
+			}
+
+			for (auto& pair : _arches) {
+				arches.at(&pair.second)->relink(pair.second.edges(), [&arches](const Archetype& arche) {
+					return arches.at(&arche);
+				});
+			}
+
+			const Archetype* lastSource{ nullptr };
+			Archetype* lastTarget{ nullptr };
+			for (auto& pair : out._entities) {
+				if (!pair.second.arche) {
+					continue;
+				}
+				if (pair.second.arche != lastSource) {
+					lastSource = pair.second.arche;
+					lastTarget = arches.at(lastSource);
+				}
+				pair.second.arche = lastTarget;
+			}
+
+			return out;
+		}
+
+		void notify(const Signature& from, const Signature& to, EntityID entity) {
+			_observers.record(ObserverEvent::ADD, to, from, entity);
+			_observers.record(ObserverEvent::REMOVE, from, to, entity);
+		}
+
+		void notify(ObserverEvent event, ComponentID component, EntityID entity) {
+			if (_observers.observes(event, component)) {
+				_observers.record(event, component, entity);
+			}
+		}
+
+		void notifyRows(const Signature& from, const Archetype& arche, size_t first) {
+			if (!_observers.active() || first == arche.size()) {
+				return;
+			}
+
+			const Signature& to{ arche.signature() };
+			if (!_observers.observes(ObserverEvent::ADD, to, from) && !_observers.observes(ObserverEvent::REMOVE, from, to)) {
+				return;
+			}
+
+			std::vector<EntityID> entities;
+			entities.reserve(arche.size() - first);
+			for (size_t _index{ first }; _index < arche.size(); ++_index) {
+				entities.push_back(arche.entity(_index));
+			}
+
+			_observers.record(ObserverEvent::ADD, to, from, entities);
+			_observers.record(ObserverEvent::REMOVE, from, to, entities);
+		}
+
+		template<typename Group, typename Function>
+		static void visit(EntityID id, Group&& group, Function& function) {
+			std::apply([id, &function](auto&... components) {
+				if constexpr (std::is_invocable_v<Function&, EntityID, decltype(components)...>) {
+					function(id, components...);
+				}
+				else {
+					function(components...);
+				}
+			}, group);
+		}
+
+		template<typename Component>
+		static void registerColumnType() {
+			ComponentID id{ Registry<Component>::id() };
+
+			if (id >= _columnTypes.size()) {
+				_columnTypes.resize(id + 1);
+			}
+
+			_columnTypes[id] = ColumnType{
+				[](std::pmr::memory_resource* resource) -> typename Archetype::UAccessor {
+					if constexpr (TAG_COMPONENT<Component>) {
+						return nullptr;
+					}
+					else {
+						return std::make_unique<typename Archetype::template Accessor<Component>>(resource);
+					}
+				},
+				[](std::pmr::memory_resource* resource) -> USparseSet<EntityID, SparseIndex> {
+					return std::make_unique<SparseSet<Component>>(resource);
+				} };
+		}
+
+		static const ColumnType& columnType(ComponentID id) {
+			if (id >= _columnTypes.size() || !_columnTypes[id].sparse) {
+				throw std::logic_error("Component must be registered with serializable<>() before it is loaded");
+			}
+			return _columnTypes[id];
+		}
+
+		template<typename Component>
+		SparseSet<Component>& sparseSet() {
+			ComponentID id{ Registry<Component>::id() };
+
+			if (id >= _sparseSets.size()) {
+				_sparseSets.resize(id + 1);
+			}
+			if (!_sparseSets[id]) {
+				_sparseSets[id] = std::make_unique<SparseSet<Component>>(_resource);
+			}
+
+			return _sparseSets[id]->template receive<Component>();
+		}
+
+		ISparseSet* sparseSet(ComponentID id) {
+			return id < _sparseSets.size() ? _sparseSets[id].get() : nullptr;
+		}
+
+		const ISparseSet* sparseSet(ComponentID id) const {
+			return id < _sparseSets.size() ? _sparseSets[id].get() : nullptr;
+		}
+
+		template<typename Component>
+		void attachSparse(EntityID id, Component&& component) {
+			using Decayed = std::decay_t<Component>;
+
+			_entities.at(id);
+			if (sparseSet<Decayed>().emplace(id, std::forward<Component>(component))) {
+				notify(ObserverEvent::ADD, Registry<Decayed>::id(), id);
+			}
+		}
+
+		void detachSparse(ComponentID component, EntityID id) {
+			if (ISparseSet* set{ sparseSet(component) }; set && set->erase(id)) {
+				notify(ObserverEvent::REMOVE, component, id);
+			}
+		}
+
+		void eraseSparse(EntityID id) {
+			for (ComponentID component{}; component < _sparseSets.size(); ++component) {
+				if (_sparseSets[component] && _sparseSets[component]->erase(id)) {
+					notify(ObserverEvent::DESTROY, component, id);
+				}
+			}
+		}
+
+		static void writeEntities(SnapshotWriter& writer, const std::vector<EntityID>& entities) {
+			writer.varint(entities.size());
+			writer.write(entities.data(), entities.size() * sizeof(EntityID));
+		}
+
+		static std::vector<EntityID> readEntities(SnapshotReader& reader) {
+			size_t count{ static_cast<size_t>(reader.varint()) };
+			if (count > std::numeric_limits<size_t>::max() / sizeof(EntityID)) {
+				throw std::runtime_error("Snapshot is truncated");
+			}
+
+			std::span<const std::byte> bytes{ reader.bytes(count * sizeof(EntityID)) };
+			std::vector<EntityID> out(count);
+			if (count) {
+				std::memcpy(out.data(), bytes.data(), bytes.size());
+			}
+			return out;
+		}
+
+		bool diffArchetype(const Archetype& arche, const _World& base, std::vector<std::byte>& out) const {
+			std::vector<ComponentID> ids;
+			std::vector<const typename Archetype::IAccessor*> columns;
+			for (ComponentID id : arche.columnIDs()) {
+				if (id != Registry<EntityID>::id()) {
+					ids.push_back(id);
+					columns.push_back(arche.columnAccessor(id));
+				}
+			}
+
+			auto result{ base._arches.find(arche.signature()) };
+			const Archetype* aligned{ result != base._arches.end() ? &result->second : nullptr };
+			size_t alignedCount{ aligned ? std::min(arche.size(), aligned->size()) : 0 };
+
+			// Rows still holding the same entity as base are compared in bulk; only the rest pay for a lookup and a diff.
+			std::vector<uint8_t> candidates(arche.size(), 1);
+			for (size_t _index{}; _index < alignedCount; ++_index) {
+				candidates[_index] = arche.entity(_index) != aligned->entity(_index);
+			}
+			for (size_t column{}; column < columns.size(); ++column) {
+				columns[column]->compare(aligned ? aligned->columnAccessor(ids[column]) : nullptr, alignedCount, candidates);
+			}
+
+			std::vector<std::vector<std::byte>> streams(columns.size());
+			std::vector<const typename Archetype::IAccessor*> bases(columns.size());
+			IndexVector marks(columns.size());
+			std::vector<EntityID> entities;
+			const Archetype* lastArche{ nullptr };
+
+			for (size_t _index{}; _index < arche.size(); ++_index) {
+				if (!candidates[_index]) {
+					continue;
+				}
+
+				EntityID id{ arche.entity(_index) };
+				const Archetype* baseArche{ nullptr };
+				size_t baseIndex{};
+
+				if (_index < alignedCount && aligned->entity(_index) == id) {
+					baseArche = aligned;
+					baseIndex = _index;
+				}
+				else if (auto result{ base._entities.find(id) }; result != base._entities.end() && result->second.arche) {
+					baseArche = result->second.arche;
+					baseIndex = result->second._index;
+				}
+
+				if (baseArche != lastArche || entities.empty()) {
+					for (size_t column{}; column < columns.size(); ++column) {
+						bases[column] = baseArche ? baseArche->columnAccessor(ids[column]) : nullptr;
+					}
+					lastArche = baseArche;
+				}
+
+				bool dirty{ !baseArche || baseArche != aligned };
+				for (size_t column{}; column < columns.size(); ++column) {
+					marks[column] = streams[column].size();
+					dirty |= columns[column]->diff(_index, bases[column], baseIndex, streams[column]);
+				}
+
+				if (dirty) {
+					entities.push_back(id);
+				}
+				else {
+					for (size_t column{}; column < columns.size(); ++column) {
+						streams[column].resize(marks[column]);
+					}
+				}
+			}
+
+			if (entities.empty()) {
+				return false;
+			}
+
+			SnapshotWriter writer{ out };
+
+			writer.varint(arche.signature().count());
+			arche.signature().each([&writer](ComponentID id) {
+				writer.value(ComponentIDGenerator::key(id));
+			});
+			writeEntities(writer, entities);
+
+			for (size_t column{}; column < columns.size(); ++column) {
+				writer.value(ComponentIDGenerator::key(ids[column]));
+				encodeRuns(streams[column], writer);
+			}
+
+			return true;
+		}
+
+		bool diffSparse(ComponentID component, const _World& base, std::vector<std::byte>& out) const {
+			const ISparseSet* set{ sparseSet(component) };
+			const ISparseSet* baseSet{ base.sparseSet(component) };
+
+			std::vector<EntityID> removed;
+			if (baseSet) {
+				for (EntityID id : baseSet->entities()) {
+					if ((!set || !set->contains(id)) && _entities.find(id) != _entities.end()) {
+						removed.push_back(id);
+					}
+				}
+			}
+
+			std::vector<EntityID> changed;
+			std::vector<std::byte> stream;
+			if (set) {
+				for (EntityID id : set->entities()) {
+					size_t mark{ stream.size() };
+					bool dirty{ !baseSet || !baseSet->contains(id) };
+					dirty |= set->diff(id, baseSet, stream);
+
+					if (dirty) {
+						changed.push_back(id);
+					}
+					else {
+						stream.resize(mark);
+					}
+				}
+			}
+
+			if (removed.empty() && changed.empty()) {
+				return false;
+			}
+
+			SnapshotWriter writer{ out };
+
+			writer.value(ComponentIDGenerator::key(component));
+			writeEntities(writer, removed);
+			writeEntities(writer, changed);
+			encodeRuns(stream, writer);
+
+			return true;
+		}
+
+		Archetype* archetype(const Signature& signature) {
+			auto result{ _arches.find(signature) };
+			if (result != _arches.end()) {
+				return &result->second;
+			}
+
+			Archetype out{ _resource };
+			signature.each([this, &out](ComponentID id) {
+				if (id != Registry<EntityID>::id()) {
+					out.emplaceAccessor(id, columnType(id).accessor(_resource));
+				}
+			});
+
+			return emplaceArchetype(signature, std::move(out));
+		}
+
+		size_t moveEntity(EntityID id, Archetype* target) {
+			if (_entities.find(id) == _entities.end()) {
+				_entities.emplace(id, EntityData{});
+			}
+
+			EntityData& data{ _entities.at(id) };
+			Archetype* source{ data.arche };
+			if (source == target) {
+				return data._index;
+			}
+
+			size_t newIndex{};
+			if (target) {
+				newIndex = source ? target->carryEntity(data._index, id, *source) : target->pushEntity(id);
+				target->pushDefaults(source);
+			}
+
+			if (source) {
+				EntityID changedEntity{ source->erase(data._index) };
+				_entities[changedEntity]._index = data._index;
+			}
+
+			data.arche = target;
+			data._index = newIndex;
+
+			if (_observers.active()) {
+				notify(source ? source->signature() : Signature{}, target ? target->signature() : Signature{}, id);
+			}
+
+			return newIndex;
+		}
+
+		template<typename... Components>
+		static Signature denseSignature() {
+			Signature out;
+			((SPARSE_STORAGE<std::decay_t<Components>> ? void() : out.set(Registry<std::decay_t<Components>>::id())), ...);
+			return out;
+		}
+
+		void indexArchetype(Archetype* arche) {
+			arche->signature().each([this, arche](ComponentID id) {
+				if (id >= _componentArches.size()) {
+					_componentArches.resize(id + 1);
+				}
+				_componentArches[id].push_back(arche);
+			});
+		}
+
+		template<typename Function>
+		void matching(const Signature& signature, Function&& function) {
+			const ArcheVector* rarest{ nullptr };
+			bool missing{ false };
+
+			signature.each([&](ComponentID id) {
+				if (id >= _componentArches.size()) {
+					missing = true;
+				}
+				else if (!rarest || _componentArches[id].size() < rarest->size()) {
+					rarest = &_componentArches[id];
+				}
+			});
+
+			if (missing) {
+				return;
+			}
+
+			if (!rarest) {
+				for (auto& pair : _arches) {
+					function(&pair.second);
+				}
+				return;
+			}
+
+			for (Archetype* arche : *rarest) {
+				if (arche->signature().includes(signature)) {
+					function(arche);
+				}
+			}
+		}
+
+		// Components the entity already had were carried over by the transfer, so those are assigned rather than pushed.
+		template<typename Component>
+		static void placeComponent(Archetype& arche, const Archetype* oldArche, size_t _index, Component&& component) {
+			if (oldArche && oldArche->signature().test(Registry<std::decay_t<Component>>::id())) {
+				if constexpr (!TAG_COMPONENT<std::decay_t<Component>>) {
+					arche.template getComponent<std::decay_t<Component>>(_index) = std::forward<Component>(component);
+				}
+			}
+			else {
+				arche.pushComponent(std::forward<Component>(component));
+			}
+		}
+
+		template<typename Component, typename... Components>
+		Archetype* attachTarget(Archetype* oldArche) {
+			// Linking an archetype to itself would turn every later detach of the component into a no-op transfer.
+			if (oldArche && oldArche->signature().test(Registry<std::decay_t<Component>>::id())
+				&& (oldArche->signature().test(Registry<std::decay_t<Components>>::id()) && ...)) {
+				return oldArche;
+			}
+
+			Archetype* newArche{ nullptr };
+
+			if constexpr (sizeof...(Components) == 0) {
+				if (oldArche) {
+					newArche = oldArche->addEdge(Registry<std::decay_t<Component>>::id());
+				}
+			}
+
+			if (!newArche) {
+				Signature signature{ Signature::template build<EntityID,Component,Components...>() };
+
+				if (oldArche) {
+					signature += oldArche->signature();
+				}
+
+				auto result{ _arches.find(signature) };
+				if (result != _arches.end()){
+					newArche = &result->second;
+				}
+				else if (oldArche) {
+					newArche = emplaceArchetype(signature, Archetype::template build<Component, Components...>(*oldArche));
+				}
+				else {
+					newArche = emplaceArchetype(signature, Archetype::template build<Component, Components...>(_resource));
+				}
+
+				if constexpr (sizeof...(Components) == 0) {
+					if (oldArche) {
+						oldArche->link(Registry<std::decay_t<Component>>::id(), *newArche);
+					}
+				}
+			}
+
+			return newArche;
+		}
+
+		template<typename Component>
+		Archetype* detachTarget(Archetype* oldArche) {
+			// As in attachTarget, an archetype linked to itself would turn later attaches of the component into no-ops.
+			if (!oldArche->signature().test(Registry<Component>::id())) {
+				return oldArche;
+			}
+
+			Archetype* newArche{ oldArche->removeEdge(Registry<Component>::id()) };
+
+			if (!newArche) {
+				Signature signature{ oldArche->signature() };
+				signature.set(Registry<Component>::id(), false);
+
+				auto result{ _arches.find(signature) };
+				if (result == _arches.end()) {
+					newArche = emplaceArchetype(signature, Archetype::build(*oldArche, Registry<Component>::id()));
+				}
+				else {
+					newArche = &result->second;
+				}
+
+				newArche->link(Registry<Component>::id(), *oldArche);
+			}
+
+			return newArche;
+		}
+
+		ArcheGroups group(std::span<const EntityID> ids) {
+			ArcheGroups out;
+
+			Archetype* lastArche{ nullptr };
+			RowVector* rows{ nullptr };
+
+			for (EntityID id : ids) {
+				EntityData& data{ _entities.at(id) };
+				if (!rows || data.arche != lastArche) {
+					lastArche = data.arche;
+					rows = &out[lastArche];
+				}
+				if (data.arche) {
+					rows->emplace_back(data._index, &data);
+				}
+			}
+
+			for (auto& pair : out) {
+				if (pair.first) {
+					sortRows(*pair.first, pair.second);
+				}
+			}
+
+			return out;
+		}
+
+		void sortRows(const Archetype& arche, RowVector& rows) {
+			if (rows.size() * 8 < arche.size()) {
+				std::sort(rows.begin(), rows.end());
+				rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+				return;
+			}
+
+			std::vector<EntityData*> slots(arche.size(), nullptr);
+			for (const Row& row : rows) {
+				slots[row.first] = row.second;
+			}
+
+			rows.clear();
+			for (size_t _index{}; _index < slots.size(); ++_index) {
+				if (slots[_index]) {
+					rows.emplace_back(_index, slots[_index]);
+				}
+			}
+		}
+
+		void moveGroup(Archetype& oldArche, Archetype& newArche, const RowVector& rows) {
+			if (rows.size() == oldArche.size()) {
+				moveAll(oldArche, newArche);
+				return;
+			}
+
+			IndexVector indices;
+			indices.reserve(rows.size());
+			for (const Row& row : rows) {
+				indices.push_back(row.first);
+			}
+
+			size_t first{ newArche.carryEntities(indices, oldArche) };
+			eraseRows(oldArche, indices);
+
+			for (const Row& row : rows) {
+				row.second->_index = first++;
+				row.second->arche = &newArche;
+			}
+		}
+
+		void eraseRows(Archetype& arche, const IndexVector& indices) {
+			arche.eraseEntities(indices);
+
+			for (size_t _index : indices) {
+				if (_index >= arche.size()) {
+					break;
+				}
+				_entities.at(arche.entity(_index))._index = _index;
+			}
+		}
+
+		// Rows must be sorted and unique; holes are filled from the tail, so only the rows moved into them are reindexed.
+		void destroyRows(Archetype& arche, const IndexVector& indices) {
+			if (indices.size() == arche.size()) {
+				destroyArchetype(arche);
+				return;
+			}
+
+			for (size_t _index : indices) {
+				EntityID id{ arche.entity(_index) };
+				if (_observers.active()) {
+					_observers.record(ObserverEvent::DESTROY, arche.signature(), id);
+				}
+				eraseSparse(id);
+				_entities.erase(id);
+			}
+
+			eraseRows(arche, indices);
+		}
+
+		void destroyArchetype(Archetype& arche) {
+			for (size_t _index{}; _index < arche.size(); ++_index) {
+				EntityID id{ arche.entity(_index) };
+				if (_observers.active()) {
+					_observers.record(ObserverEvent::DESTROY, arche.signature(), id);
+				}
+				eraseSparse(id);
+				_entities.erase(id);
+			}
+
+			arche.clear();
+		}
+
+		void moveAll(Archetype& oldArche, Archetype& newArche) {
+			reindex(newArche, newArche.carryAll(oldArche));
+		}
+
+		struct PendingEntity {
+			using Payload = typename CommandBuffer<_World>::IPayload;
+			using PayloadVector = std::vector<std::pair<ComponentID, Payload*>>;
+
+			EntityID id;
+			bool created{ false };
+			bool destroyed{ false };
+			Signature added;
+			Signature removed;
+			PayloadVector payloads;
+			EntityData* data{ nullptr };
+
+			explicit PendingEntity(EntityID id)
+				: id{ id } {
+			}
+
+			void set(ComponentID component, Payload* payload) {
+				added.set(component);
+				removed.set(component, false);
+				for (auto& pair : payloads) {
+					if (pair.first == component) {
+						pair.second = payload;
+						return;
+					}
+				}
+				payloads.emplace_back(component, payload);
+			}
+
+			void unset(ComponentID component) {
+				added.set(component, false);
+				removed.set(component);
+				std::erase_if(payloads, [component](const auto& pair) {
+					return pair.first == component;
+				});
+			}
+
+			Payload* payload(ComponentID component) const {
+				for (const auto& pair : payloads) {
+					if (pair.first == component) {
+						return pair.second;
+					}
+				}
+				return nullptr;
+			}
+		};
+
+		void playback(std::span<CommandBuffer<_World>* const> buffers) {
+			using CommandType = typename CommandBuffer<_World>::CommandType;
+			using PendingGroups = std::unordered_map<Archetype*, std::unordered_map<Signature, std::vector<PendingEntity*>>>;
+
+			std::vector<PendingEntity> pending;
+			std::unordered_map<EntityID, size_t> lookup;
+			std::vector<typename CommandBuffer<_World>::Command*> sparse;
+
+			for (CommandBuffer<_World>* buffer : buffers) {
+				for (auto& command : buffer->commands()) {
+					auto result{ lookup.try_emplace(command.entity, pending.size()) };
+					if (result.second) {
+						pending.push_back(PendingEntity{ command.entity });
+					}
+
+					PendingEntity& entity{ pending[result.first->second] };
+					if (entity.destroyed) {
+						continue;
+					}
+
+					if (command.sparse) {
+						sparse.push_back(&command);
+						continue;
+					}
+
+					switch (command.type) {
+					case CommandType::CREATE:
+						entity.created = true;
+						break;
+					case CommandType::DESTROY:
+						entity.destroyed = true;
+						break;
+					case CommandType::ATTACH:
+						entity.set(command.component, command.payload.get());
+						break;
+					case CommandType::DETACH:
+						entity.unset(command.component);
+						break;
+					}
+				}
+			}
+
+			for (PendingEntity& entity : pending) {
+				if (entity.created) {
+					_entities.emplace(entity.id, EntityData{});
+				}
+			}
+
+			for (PendingEntity& entity : pending) {
+				if (entity.created && entity.destroyed) {
+					_entities.erase(entity.id);
+				}
+			}
+
+			ArcheGroups destroyed;
+			for (PendingEntity& entity : pending) {
+				if (entity.destroyed && !entity.created) {
+					EntityData& data{ _entities.at(entity.id) };
+					if (data.arche) {
+						destroyed[data.arche].emplace_back(data._index, &data);
+					}
+				}
+			}
+
+			for (auto& pair : destroyed) {
+				sortRows(*pair.first, pair.second);
+
+				if (_observers.active()) {
+					for (const Row& row : pair.second) {
+						_observers.record(ObserverEvent::DESTROY, pair.first->signature(), pair.first->entity(row.first));
+					}
+				}
+
+				IndexVector indices;
+				indices.reserve(pair.second.size());
+				for (const Row& row : pair.second) {
+					indices.push_back(row.first);
+				}
+				eraseRows(*pair.first, indices);
+			}
+
+			for (PendingEntity& entity : pending) {
+				if (entity.destroyed && !entity.created) {
+					eraseSparse(entity.id);
+					_entities.erase(entity.id);
+				}
+			}
+
+			PendingGroups groups;
+			for (PendingEntity& entity : pending) {
+				if (entity.destroyed || (entity.payloads.empty() && !entity.removed.any())) {
+					continue;
+				}
+
+				entity.data = &_entities.at(entity.id);
+				Archetype* source{ entity.data->arche };
+
+				Signature signature{ source ? source->signature() : Signature{} };
+				Signature target{ (signature + entity.added) - entity.removed };
+				if (!source && target.any()) {
+					target.set(Registry<EntityID>::id());
+				}
+
+				if (target == signature) {
+					for (auto& pair : entity.payloads) {
+						pair.second->assign(*source, entity.data->_index);
+					}
+					continue;
+				}
+
+				groups[source][target].push_back(&entity);
+			}
+
+			for (auto& sourcePair : groups) {
+				Archetype* source{ sourcePair.first };
+
+				for (auto& targetPair : sourcePair.second) {
+					std::vector<PendingEntity*>& entities{ targetPair.second };
+					Archetype* target{ playbackTarget(source, targetPair.first, *entities.front()) };
+
+					if (source) {
+						std::sort(entities.begin(), entities.end(), [](PendingEntity* left, PendingEntity* right) {
+							return left->data->_index < right->data->_index;
+						});
+
+						RowVector rows;
+						rows.reserve(entities.size());
+						for (PendingEntity* entity : entities) {
+							rows.emplace_back(entity->data->_index, entity->data);
+						}
+						moveGroup(*source, *target, rows);
+					}
+					else {
+						for (PendingEntity* entity : entities) {
+							entity->data->_index = target->pushEntity(entity->id);
+							entity->data->arche = target;
+						}
+					}
+
+					Signature added{ targetPair.first - (source ? source->signature() : Signature{}) };
+					added.set(Registry<EntityID>::id(), false);
+
+					for (ComponentID component : target->columnIDs()) {
+						if (added.test(component)) {
+							for (PendingEntity* entity : entities) {
+								entity->payload(component)->push(*target);
+							}
+						}
+					}
+
+					for (PendingEntity* entity : entities) {
+						for (auto& pair : entity->payloads) {
+							if (!added.test(pair.first)) {
+								pair.second->assign(*target, entity->data->_index);
+							}
+						}
+					}
+
+					if (_observers.active()) {
+						Signature from{ source ? source->signature() : Signature{} };
+						for (PendingEntity* entity : entities) {
+							notify(from, target->signature(), entity->id);
+						}
+					}
+				}
+			}
+
+			for (auto* command : sparse) {
+				if (pending[lookup.at(command->entity)].destroyed) {
+					continue;
+				}
+
+				if (command->type == CommandType::ATTACH) {
+					command->payload->attach(*this, command->entity);
+				}
+				else {
+					detachSparse(command->component, command->entity);
+				}
+			}
+
+			for (CommandBuffer<_World>* buffer : buffers) {
+				buffer->commands().clear();
+			}
+		}
+
+		Archetype* playbackTarget(Archetype* source, const Signature& signature, const PendingEntity& entity) {
+			auto result{ _arches.find(signature) };
+			if (result != _arches.end()) {
+				return &result->second;
+			}
+
+			Archetype out{ source ? Archetype::template build<>(*source) : Archetype{ _resource } };
+
+			if (source) {
+				source->signature().each([&](ComponentID component) {
+					if (!signature.test(component)) {
+						out.eraseAccessor(component);
+					}
+				});
+			}
+
+			for (auto& pair : entity.payloads) {
+				if (signature.test(pair.first)) {
+					out.emplaceAccessor(pair.first, pair.second->accessor(_resource));
+				}
+			}
+
+			return emplaceArchetype(signature, std::move(out));
+		}
+
+		void reindex(Archetype& arche, size_t first) {
+			for (size_t _index{ first }; _index < arche.size(); ++_index) {
+				EntityData& data{ _entities.at(arche.entity(_index)) };
+				data._index = _index;
+				data.arche = &arche;
+			}
+		}
+
+	public:
+		template<typename... Components>
+		class ViewIterator {
+		public:
+			using Cache = Archetype::template Cache<Components...>;
+			using ComponentGroup = typename Cache::ComponentGroup;
+
+		private:
+			const ArcheVector* _arches;
+			size_t _cacheIndex;
+			size_t _index;
+			const TickFilterVector* _filters;
+			Tick _since;
+			size_t _size{};
+			Cache _cache;
+
+		public:
+			ViewIterator(
+				const ArcheVector& _archeVector,
+				size_t _cacheIndex,
+				size_t _index,
+				const TickFilterVector* _filters = nullptr,
+				Tick _since = 0)
+				: _arches{ &_archeVector }, _cacheIndex{ _cacheIndex }, _index{ _index }, _filters{ _filters }, _since{ _since } {
+				enter();
+				seek();
+			}
+
+			ViewIterator& operator++() {
+				++_index;
+				seek();
+				return *this;
+			}
+
+			ComponentGroup operator*() {
+				return _cache.group(_index);
+			}
+
+			bool operator==(const ViewIterator& left) const {
+				return _cacheIndex == left._cacheIndex;
+			}
+
+			bool operator!=(const ViewIterator& left) const {
+				return !(*this == left);
+			}
+
+		private:
+			void enter() {
+				if (_cacheIndex < _arches->size()) {
+					_size = (*_arches)[_cacheIndex]->size();
+					if (_size) {
+						_cache = Cache{ *(*_arches)[_cacheIndex] };
+					}
+				}
+			}
+
+			void seek() {
+				while (_cacheIndex < _arches->size()) {
+					if (_index < _size) {
+						if (!_filters || _filters->empty() || (*_arches)[_cacheIndex]->passes(*_filters, _since, _index)) {
+							return;
+						}
+						++_index;
+						continue;
+					}
+
+					_index = 0;
+					++_cacheIndex;
+					enter();
+				}
+			}
+
+		};
+
+		template<typename... Components>
+		class View {
+		public:
+			using Iterator = ViewIterator<Components...>;
+			using SetArray = std::array<ISparseSet*, sizeof...(Components)>;
+
+			inline static constexpr bool SPARSE{ (SPARSE_STORAGE<std::decay_t<Components>> || ...) };
+			inline static constexpr bool DENSE{ (!SPARSE_STORAGE<std::decay_t<Components>> || ...) };
+
+			struct Range {
+				Archetype* arche;
+				size_t first;
+				size_t last;
+			};
+
+			using RangeVector = std::vector<Range>;
+
+		private:
+			ArcheVector _archeVector;
+			const ArcheVector* _arches;
+			_World* _world;
+			TickFilterVector _filters;
+			Tick _since{};
+			bool _narrowed{ false };
+
+		public:
+			View(_World& world)
+				: _arches{ &_archeVector }, _world{ &world } {
+				world.matching(denseSignature<Components...>(), [this](Archetype* arche) {
+					if (!arche->empty()) {
+						_archeVector.push_back(arche);
+					}
+				});
+			}
+
+			View(_World& world, const QueryState& state)
+				: _arches{ &state.arches }, _world{ &world } {
+			}
+
+			View(const View& left)
+				: _archeVector{ left._archeVector },
+				_arches{ left.owns() ? &_archeVector : left._arches },
+				_world{ left._world },
+				_filters{ left._filters },
+				_since{ left._since },
+				_narrowed{ left._narrowed } {
+			}
+
+			View& operator=(const View& left) {
+				_archeVector = left._archeVector;
+				_arches = left.owns() ? &_archeVector : left._arches;
+				_world = left._world;
+				_filters = left._filters;
+				_since = left._since;
+				_narrowed = left._narrowed;
+				return *this;
+			}
+
+			const ArcheVector& archetypes() const {
+				return *_arches;
+			}
+
+			bool filtered() const {
+				return !_filters.empty();
+			}
+
+			Iterator begin() {
+				static_assert(!SPARSE, "Views over sparse components are walked with each()");
+				return Iterator{ *_arches, 0, 0, &_filters, _since };
+			}
+
+			Iterator end() {
+				return Iterator{ *_arches, _arches->size(), 0 };
+			}
+
+			template<typename Function>
+			void each(Function&& function) {
+				if constexpr (SPARSE) {
+					join([&function](EntityID id, Archetype* arche, size_t _index, const SetArray& sets) {
+						call(function, id, arche, _index, sets, std::index_sequence_for<Components...>{});
+					});
+				}
+				else {
+					for (Archetype* arche : *_arches) {
+						arche->template each<Components...>(_filters, _since, function);
+					}
+				}
+			}
+
+			std::vector<EntityID> entities() {
+				std::vector<EntityID> out;
+
+				if constexpr (SPARSE) {
+					join([&out](EntityID id, Archetype*, size_t, const SetArray&) {
+						out.push_back(id);
+					});
+				}
+				else {
+					for (Archetype* arche : *_arches) {
+						arche->template each<>(_filters, _since, [&out](EntityID id) {
+							out.push_back(id);
+						});
+					}
+				}
+
+				return out;
+			}
+
+			template<typename Function>
+			void eachChunk(Function&& function) {
+				static_assert(!SPARSE, "Sparse components are not stored in archetype chunks");
+
+				for (Archetype* arche : *_arches) {
+					arche->template eachChunk<Components...>(_filters, _since, function);
+				}
+			}
+
+			template<typename Function>
+			void parallelEach(Function&& function, size_t grain = 4096) {
+				static_assert(!SPARSE, "Sparse components are not stored in archetype chunks");
+
+				grain = std::max<size_t>(grain, 1);
+
+				RangeVector ranges;
+				std::vector<size_t> tasks{ 0 };
+				size_t load{};
+
+				for (Archetype* arche : *_arches) {
+					arche->template unshare<Components...>();
+
+					size_t count{ arche->size() };
+					for (size_t first{}; first < count;) {
+						size_t length{ std::min(grain - load, count - first) };
+						ranges.push_back(Range{ arche, first, first + length });
+
+						first += length;
+						load += length;
+						if (load == grain) {
+							tasks.push_back(ranges.size());
+							load = 0;
+						}
+					}
+				}
+
+				if (tasks.back() != ranges.size()) {
+					tasks.push_back(ranges.size());
+				}
+
+				_world->threadPool().run(tasks.size() - 1, [&](size_t task) {
+					for (size_t _index{ tasks[task] }; _index < tasks[task + 1]; ++_index) {
+						const Range& range{ ranges[_index] };
+						range.arche->template each<Components...>(range.first, range.last, _filters, _since, function);
+					}
+				});
+			}
+
+			template<typename... _Components>
+			View include() {
+				static_assert(!(SPARSE_STORAGE<std::decay_t<_Components>> || ...), "include() filters archetype components");
+
+				Signature signature{ Signature::template build<_Components...>() };
+				ArcheVector newArches;
+
+				for (auto arche : *_arches) {
+					if (arche->signature().includes(signature) && !arche->empty()) {
+						newArches.push_back(arche);
+					}
+				}
+
+				_archeVector = std::move(newArches);
+				_arches = &_archeVector;
+				_narrowed = true;
+
+				return *this;
+			}
+
+			template<typename... _Components>
+			View exclude() {
+				static_assert(!(SPARSE_STORAGE<std::decay_t<_Components>> || ...), "exclude() filters archetype components");
+
+				Signature signature{ Signature::template build<_Components...>() };
+				ArcheVector newArches;
+
+				for (auto arche : *_arches) {
+					if (!arche->signature().matches(signature) && !arche->empty()) {
+						newArches.push_back(arche);
+					}
+				}
+
+				_archeVector = std::move(newArches);
+				_arches = &_archeVector;
+				_narrowed = true;
+
+				return *this;
+			}
+
+			template<typename... Filters>
+			View filter(Tick since) {
+				static_assert((TRACK_CHANGES<std::decay_t<typename Filters::Type>> && ...),
+					"Added/Changed filters need TRACK_CHANGES enabled for the component");
+				static_assert(!(SPARSE_STORAGE<std::decay_t<typename Filters::Type>> || ...),
+					"Added/Changed filters apply to archetype components");
+				static_assert(!(TAG_COMPONENT<std::decay_t<typename Filters::Type>> || ...),
+					"Tag components have no column to track changes on");
+
+				(_filters.push_back(TickFilter{ Registry<std::decay_t<typename Filters::Type>>::id(), Filters::ADDED }), ...);
+				_since = since;
+
+				return *this;
+			}
+
+		private:
+			bool owns() const {
+				return _arches == &_archeVector;
+			}
+
+			template<typename Visitor>
+			void join(Visitor&& visitor) {
+				constexpr std::array<bool, sizeof...(Components)> sparse{ SPARSE_STORAGE<std::decay_t<Components>>... };
+
+				SetArray sets{ (SPARSE_STORAGE<std::decay_t<Components>> ?
+					_world->sparseSet(Registry<std::decay_t<Components>>::id()) : nullptr)... };
+
+				const ISparseSet* smallest{ nullptr };
+				for (size_t _index{}; _index < sets.size(); ++_index) {
+					if (!sparse[_index]) {
+						continue;
+					}
+					if (!sets[_index]) {
+						return;
+					}
+					if (!smallest || sets[_index]->size() < smallest->size()) {
+						smallest = sets[_index];
+					}
+				}
+
+				auto contained{ [&sets](EntityID id) {
+					for (ISparseSet* set : sets) {
+						if (set && !set->contains(id)) {
+							return false;
+						}
+					}
+					return true;
+				} };
+
+				size_t rows{};
+				for (Archetype* arche : *_arches) {
+					rows += arche->size();
+				}
+
+				if (DENSE && rows <= smallest->size()) {
+					for (Archetype* arche : *_arches) {
+						for (size_t _index{}; _index < arche->size(); ++_index) {
+							EntityID id{ arche->entity(_index) };
+							if (contained(id) && (_filters.empty() || arche->passes(_filters, _since, _index))) {
+								visitor(id, arche, _index, sets);
+							}
+						}
+					}
+					return;
+				}
+
+				bool restricted{ DENSE || _narrowed || !_filters.empty() };
+				ArcheVector sorted;
+				if (restricted) {
+					sorted = *_arches;
+					std::sort(sorted.begin(), sorted.end());
+				}
+
+				std::span<const EntityID> entities{ smallest->entities() };
+				for (size_t _index{}; _index < entities.size(); ++_index) {
+					EntityID id{ entities[_index] };
+					if (!contained(id)) {
+						continue;
+					}
+
+					if (!restricted) {
+						visitor(id, nullptr, 0, sets);
+						continue;
+					}
+
+					auto result{ _world->_entities.find(id) };
+					if (result == _world->_entities.end()) {
+						continue;
+					}
+
+					const EntityData& data{ result->second };
+					if (data.arche && std::binary_search(sorted.begin(), sorted.end(), data.arche)
+						&& (_filters.empty() || data.arche->passes(_filters, _since, data._index))) {
+						visitor(id, data.arche, data._index, sets);
+					}
+				}
+			}
+
+			template<typename Component>
+			static Component& fetch(Archetype* arche, size_t _index, EntityID id, ISparseSet* set, TagSlot<std::decay_t<Component>>& tag) {
+				if constexpr (SPARSE_STORAGE<std::decay_t<Component>>) {
+					return set->template receive<std::decay_t<Component>>().get(id);
+				}
+				else if constexpr (TAG_COMPONENT<std::decay_t<Component>>) {
+					return tag.value;
+				}
+				else if constexpr (std::is_const_v<Component>) {
+					return static_cast<const Archetype*>(arche)->template getComponent<std::decay_t<Component>>(_index);
+				}
+				else {
+					return arche->template getComponent<Component>(_index);
+				}
+			}
+
+			template<typename Function, size_t... Indices>
+			static void call(Function& function, EntityID id, Archetype* arche, size_t _index, const SetArray& sets, std::index_sequence<Indices...>) {
+				std::tuple<TagSlot<std::decay_t<Components>>...> tags;
+				if constexpr (std::is_invocable_v<Function&, EntityID, Components&...>) {
+					function(id, fetch<Components>(arche, _index, id, sets[Indices], std::get<Indices>(tags))...);
+				}
+				else {
+					function(fetch<Components>(arche, _index, id, sets[Indices], std::get<Indices>(tags))...);
+				}
+			}
+
+		};
+
+		template<typename... Components>
+		class Query {
+		private:
+			_World* _world;
+			const QueryState* _state;
+
+		public:
+			Query(_World& world, const QueryState& state)
+				: _world{ &world }, _state{ &state } {
+			}
+
+			View<Components...> view() const {
+				return View<Components...>{ *_world, *_state };
+			}
+
+			const ArcheVector& archetypes() const {
+				return _state->arches;
+			}
+
+			template<typename Function>
+			void each(Function&& function) const {
+				view().each(std::forward<Function>(function));
+			}
+		};
+
+		template<typename... Components>
+		Query<Components...> query() {
+			Signature signature{ denseSignature<Components...>() };
+
+			std::unique_ptr<QueryState>& state{ _queries[signature] };
+			if (!state) {
+				state = std::make_unique<QueryState>();
+				state->signature = signature;
+
+				matching(signature, [&state](Archetype* arche) {
+					state->arches.push_back(arche);
+				});
+			}
+
+			return Query<Components...>{ *this, *state };
+		}
 
 		template<typename... Components>
 		View<Components...> components() {